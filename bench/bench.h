@@ -0,0 +1,228 @@
+#pragma once
+// The MIT License (MIT)
+//
+// Copyright (c) 2019 jh0x
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <intern/interner_demo_traits.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <parallel_hashmap/phmap.h>
+
+// Minimal micro-benchmark harness: BENCHMARK(group) registers a function
+// that reports any number of measurements through bench::runner::run().
+
+namespace bench
+{
+
+struct result
+{
+    std::string group;
+    std::string name;
+    std::size_t ops;
+    double value;
+    std::string unit;
+};
+
+class runner
+{
+public:
+    explicit runner(std::string group) : _group{std::move(group)} {}
+
+    // body() performs `ops` operations, setup() is not timed. The best of
+    // several repetitions is kept.
+    template<typename Setup, typename Body>
+    void run(const std::string& name, std::size_t ops, Setup&& setup, Body&& body)
+    {
+        using clock = std::chrono::steady_clock;
+        double best = 1e300;
+        for(int rep = 0; rep != kRepetitions; ++rep)
+        {
+            setup();
+            const auto t0 = clock::now();
+            body();
+            const auto t1 = clock::now();
+            best = std::min(best,
+                    std::chrono::duration<double, std::nano>(t1 - t0).count());
+        }
+        _results.push_back({_group, name, ops,
+                best / std::max<std::size_t>(ops, 1), "ns/op"});
+    }
+    template<typename Body>
+    void run(const std::string& name, std::size_t ops, Body&& body)
+    {
+        run(name, ops, []{}, std::forward<Body>(body));
+    }
+
+    // Anything that is not a time: memory, ratios...
+    void report(const std::string& name, std::size_t n, double value,
+            const std::string& unit)
+    {
+        _results.push_back({_group, name, n, value, unit});
+    }
+
+    const std::vector<result>& results() const noexcept { return _results; }
+
+private:
+    constexpr static int kRepetitions = 5;
+    std::string _group;
+    std::vector<result> _results;
+};
+
+using bench_fn = void (*)(runner&);
+
+inline std::vector<std::pair<const char*, bench_fn>>& registry()
+{
+    static std::vector<std::pair<const char*, bench_fn>> r;
+    return r;
+}
+
+struct registrar
+{
+    registrar(const char* group, bench_fn fn)
+    {
+        registry().emplace_back(group, fn);
+    }
+};
+
+#define BENCH_CAT2(a, b) a##b
+#define BENCH_CAT(a, b) BENCH_CAT2(a, b)
+#define BENCHMARK(group)                                                \
+    static void BENCH_CAT(bench_fn_, __LINE__)(bench::runner&);         \
+    static const bench::registrar BENCH_CAT(bench_reg_, __LINE__){      \
+        group, &BENCH_CAT(bench_fn_, __LINE__)};                        \
+    static void BENCH_CAT(bench_fn_, __LINE__)(bench::runner& r)
+
+template<typename T>
+inline void do_not_optimize(const T& v)
+{
+    asm volatile("" : : "r,m"(v) : "memory");
+}
+
+///////////////////////////////////////////////////////////////////////
+// Inputs
+
+inline const std::vector<std::string>& words()
+{
+    static const std::vector<std::string> w = []
+    {
+        std::vector<std::string> normal;
+        std::ifstream f("test/words.txt", std::fstream::in);
+        std::string s;
+        while(std::getline(f, s))
+        {
+            normal.push_back(s);
+        }
+        return normal;
+    }();
+    return w;
+}
+
+// Deterministic "random" numbers so that runs are comparable
+struct lcg
+{
+    std::uint64_t _s;
+    std::uint64_t operator()() noexcept
+    {
+        _s = _s * 6364136223846793005ULL + 1442695040888963407ULL;
+        return _s >> 17;
+    }
+};
+
+// n strings that are all different: words with a numeric suffix
+inline std::vector<std::string> unique_strings(std::size_t n)
+{
+    const auto& w = words();
+    std::vector<std::string> out;
+    out.reserve(n);
+    for(std::size_t i = 0; i != n; ++i)
+    {
+        out.push_back(w[i % w.size()] + '#' + std::to_string(i));
+    }
+    return out;
+}
+
+///////////////////////////////////////////////////////////////////////
+// Interner configuration with an arena that can be reset between runs
+
+template<std::size_t N, typename HasherT = intern::interner_sample_hash>
+struct bench_traits
+{
+    using hasherT = HasherT;
+    template<typename K, typename V>
+    using lookupT = phmap::parallel_flat_hash_map<K, V>;
+
+    static void* allocate(std::size_t s, std::size_t a)
+        noexcept(noexcept(intern::_bad_alloc()))
+    {
+        _off() = ((_off() + (a - 1)) & -a);
+        void* ptr = _buf() + _off();
+        _off() += s;
+        if(_off() > N)
+        {
+            intern::_bad_alloc();
+        }
+        return ptr;
+    }
+    static void raze() noexcept
+    {
+        _off() = 0;
+    }
+    static std::uint32_t offset(const char* p) noexcept
+    {
+        return static_cast<std::uint32_t>(p - _buf());
+    }
+    static const char* address(std::uint32_t o) noexcept
+    {
+        return _buf() + o;
+    }
+    static std::size_t used() noexcept
+    {
+        return _off();
+    }
+    static char* _buf()
+    {
+        static std::unique_ptr<char[]> buf(new char[N]);
+        return buf.get();
+    }
+    static std::size_t& _off() noexcept
+    {
+        static std::size_t off;
+        return off;
+    }
+};
+
+template<std::size_t N>
+struct bench_compact_traits : bench_traits<N>
+{
+    constexpr static auto compact_index = true;
+};
+
+}
@@ -0,0 +1,92 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2019 jh0x
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "bench.h"
+
+#include <intern/arena.hpp>
+#include <intern/interner.hpp>
+
+namespace x = intern;
+
+// Fixed static buffer vs a growable arena with and without huge pages:
+// intern a million strings, then read them back in random order
+
+namespace
+{
+
+template<typename ITraits>
+void run_arena(bench::runner& r, const std::string& name,
+        const std::vector<std::string>& in, const std::vector<std::size_t>& order)
+{
+    using interner_t = x::interner<ITraits>;
+    std::unique_ptr<interner_t> i;
+    std::vector<typename interner_t::stringF> out;
+    r.run(name + "/miss", in.size(), [&]
+    {
+        out.clear();
+        i.reset();
+        if constexpr(!x::details::has_allocator<ITraits>::value)
+        {
+            ITraits::raze();
+        }
+        i.reset(new interner_t);
+    }, [&]
+    {
+        for(auto& s : in)
+        {
+            out.push_back(i->far(s));
+        }
+    });
+    r.run(name + "/scan", order.size(), [&]
+    {
+        std::size_t acc = 0;
+        for(auto n : order)
+        {
+            acc += out[n].size() + static_cast<unsigned char>(out[n][0]);
+        }
+        bench::do_not_optimize(acc);
+    });
+    if constexpr(x::details::has_allocator<ITraits>::value)
+    {
+        r.report(name + "/reserved", in.size(),
+                double(i->allocator().reserved()) / (1 << 20), "MB");
+    }
+}
+
+}
+
+BENCHMARK("arena")
+{
+    const auto in = bench::unique_strings(1 << 20);
+    std::vector<std::size_t> order;
+    bench::lcg rnd{11};
+    for(std::size_t n = 0; n != in.size(); ++n)
+    {
+        order.push_back(rnd() % in.size());
+    }
+    run_arena<bench::bench_traits<(1 << 26)>>(r, "static", in, order);
+    run_arena<x::interner_sample_arena_traits<>>(r, "normal", in, order);
+    run_arena<x::interner_sample_arena_traits<
+        x::arena_pages::transparent_huge>>(r, "thp", in, order);
+    run_arena<x::interner_sample_arena_traits<
+        x::arena_pages::explicit_huge>>(r, "hugetlb", in, order);
+}
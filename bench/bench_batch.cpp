@@ -0,0 +1,139 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2019 jh0x
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "bench.h"
+
+#include <intern/interner.hpp>
+
+#include <string_view>
+
+namespace x = intern;
+
+// Scalar loop vs far_batch() over packet sized batches
+
+namespace
+{
+
+constexpr std::size_t kBatch = 128;
+constexpr std::size_t kArena = 1 << 26;
+using traits = bench::bench_traits<kArena>;
+using interner_t = x::interner<traits>;
+
+std::vector<std::string_view> views(const std::vector<std::string>& in)
+{
+    return {in.begin(), in.end()};
+}
+
+}
+
+BENCHMARK("batch/hit")
+{
+    // Every string is already interned, the table is way bigger than the
+    // caches and the strings are looked up in random order
+    const auto w = bench::unique_strings(1 << 20);
+    std::vector<std::string_view> in;
+    bench::lcg rnd{42};
+    for(std::size_t i = 0; i != 1 << 18; ++i)
+    {
+        in.push_back(w[rnd() % w.size()]);
+    }
+
+    traits::raze();
+    interner_t i;
+    for(auto& s : w)
+    {
+        i.far(s);
+    }
+    std::vector<interner_t::stringF> out(in.size(), i.far(""));
+
+    r.run("scalar", in.size(), [&]
+    {
+        for(std::size_t n = 0; n != in.size(); ++n)
+        {
+            out[n] = i.far(in[n].data(), in[n].size());
+        }
+        bench::do_not_optimize(out.back());
+    });
+    r.run("batch", in.size(), [&]
+    {
+        for(std::size_t n = 0; n < in.size(); n += kBatch)
+        {
+            i.far_batch(in.data() + n, std::min(kBatch, in.size() - n),
+                    out.data() + n);
+        }
+        bench::do_not_optimize(out.back());
+    });
+    r.run("sso1_16/scalar", in.size(), [&]
+    {
+        for(std::size_t n = 0; n != in.size(); ++n)
+        {
+            bench::do_not_optimize(i.sso1<16>(in[n].data(), in[n].size()));
+        }
+    });
+    r.run("sso1_16/batch", in.size(), [&]
+    {
+        std::vector<interner_t::stringS1<16>> tmp;
+        tmp.reserve(kBatch);
+        for(std::size_t n = 0; n < in.size(); n += kBatch)
+        {
+            tmp.clear();
+            i.sso1_batch<16>(in.data() + n, std::min(kBatch, in.size() - n),
+                    std::back_inserter(tmp));
+            bench::do_not_optimize(tmp.back());
+        }
+    });
+}
+
+BENCHMARK("batch/miss")
+{
+    // Every string is new
+    const auto strings = bench::unique_strings(1 << 18);
+    const auto in = views(strings);
+    std::unique_ptr<interner_t> i;
+    std::vector<interner_t::stringF> out;
+
+    auto setup = [&]
+    {
+        i.reset();
+        traits::raze();
+        i.reset(new interner_t);
+        out.assign(in.size(), i->far(""));
+    };
+
+    r.run("scalar", in.size(), setup, [&]
+    {
+        for(std::size_t n = 0; n != in.size(); ++n)
+        {
+            out[n] = i->far(in[n].data(), in[n].size());
+        }
+        bench::do_not_optimize(out.back());
+    });
+    r.run("batch", in.size(), setup, [&]
+    {
+        for(std::size_t n = 0; n < in.size(); n += kBatch)
+        {
+            i->far_batch(in.data() + n, std::min(kBatch, in.size() - n),
+                    out.data() + n);
+        }
+        bench::do_not_optimize(out.back());
+    });
+}
@@ -0,0 +1,136 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2019 jh0x
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "bench.h"
+
+#include <intern/interned_column.hpp>
+#include <intern/interner.hpp>
+
+#include <algorithm>
+#include <iterator>
+
+namespace x = intern;
+
+// Filtering a column of a million sso1<16> rows: a std::vector of the
+// strings themselves vs interned_column
+
+namespace
+{
+
+constexpr std::size_t kRows = 1 << 20;
+constexpr std::size_t kNeedles = 4;
+
+using interner_t = x::interner<x::interner_sample_arena_traits<>>;
+using stringS = interner_t::stringS1<16>;
+
+}
+
+BENCHMARK("column")
+{
+    interner_t i;
+    std::vector<stringS> rows;
+    rows.reserve(kRows);
+    const auto& w = bench::words();
+    for(std::size_t k = 0; k != kRows; ++k)
+    {
+        rows.push_back(i.sso1<16>(w[k * 7919 % w.size()]));
+    }
+    const x::interned_column<stringS> col(rows.begin(), rows.end());
+
+    // One small and one far needle of each kind
+    std::vector<stringS> needles;
+    for(std::size_t k = 0; needles.size() != kNeedles; ++k)
+    {
+        if(rows[k].small() == (needles.size() % 2 == 0))
+        {
+            needles.push_back(rows[k]);
+        }
+    }
+
+    r.run("vector/count_equal", kRows * kNeedles, [&]
+    {
+        std::size_t n = 0;
+        for(const auto& needle : needles)
+        {
+            n += static_cast<std::size_t>(
+                    std::count(rows.begin(), rows.end(), needle));
+        }
+        bench::do_not_optimize(n);
+    });
+    r.run("column/count_equal", kRows * kNeedles, [&]
+    {
+        std::size_t n = 0;
+        for(const auto& needle : needles)
+        {
+            n += col.count_equal(needle);
+        }
+        bench::do_not_optimize(n);
+    });
+    r.run("vector/find_equal", kRows * kNeedles, [&]
+    {
+        for(const auto& needle : needles)
+        {
+            std::vector<std::uint64_t> bits((kRows + 63) / 64);
+            for(std::size_t k = 0; k != kRows; ++k)
+            {
+                bits[k / 64] |= std::uint64_t(rows[k] == needle) << (k % 64);
+            }
+            bench::do_not_optimize(bits);
+        }
+    });
+    r.run("column/find_equal", kRows * kNeedles, [&]
+    {
+        for(const auto& needle : needles)
+        {
+            auto bits = col.find_equal(needle);
+            bench::do_not_optimize(bits);
+        }
+    });
+
+    std::vector<std::size_t> picks;
+    for(std::size_t k = 0; k != kRows / 16; ++k)
+    {
+        picks.push_back(k * 40503 % kRows);
+    }
+    std::vector<stringS> out;
+    out.reserve(picks.size());
+    r.run("column/materialize", picks.size(), [&] { out.clear(); }, [&]
+    {
+        col.materialize(picks.begin(), picks.end(), std::back_inserter(out));
+    });
+    r.run("vector/count_distinct", kRows, [&]
+    {
+        x::flat_map<stringS, bool> seen;
+        for(const auto& s : rows)
+        {
+            seen.try_emplace(s);
+        }
+        bench::do_not_optimize(seen.size());
+    });
+    r.run("column/count_distinct", kRows, [&]
+    {
+        bench::do_not_optimize(col.count_distinct());
+    });
+    r.report("vector/bytes", kRows,
+            double(rows.capacity() * sizeof(stringS)) / kRows, "B/row");
+    r.report("column/bytes", kRows, double(col.bytes()) / kRows, "B/row");
+}
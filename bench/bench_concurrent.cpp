@@ -0,0 +1,129 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2019 jh0x
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "bench.h"
+
+#include <intern/interner.hpp>
+
+#include <memory>
+#include <string_view>
+#include <thread>
+
+namespace x = intern;
+
+// Scaling of one shared concurrent interner over words.txt with 1 to 16
+// threads, each going through all the words in its own order:
+// - insert: a fresh interner, so the threads race on the misses
+// - lookup: everything interned already, only shared submap locks
+// ns/op is wall time over the operations of all threads, speedup is
+// relative to one thread. Linear scaling needs as many cores.
+
+namespace
+{
+
+using traits = x::interner_sample_concurrent_traits<(1 << 21)>;
+using interner_t = x::interner<traits>;
+
+constexpr std::size_t kLookupsPerThread = 1 << 18;
+
+std::vector<std::vector<std::string_view>> shuffled(std::size_t threads)
+{
+    const auto& w = bench::words();
+    std::vector<std::vector<std::string_view>> out(threads);
+    for(std::size_t t = 0; t != threads; ++t)
+    {
+        out[t].assign(w.begin(), w.end());
+        bench::lcg rnd{t + 1};
+        for(std::size_t n = out[t].size(); n > 1; --n)
+        {
+            std::swap(out[t][n - 1], out[t][rnd() % n]);
+        }
+    }
+    return out;
+}
+
+template<typename F>
+void in_threads(std::size_t threads, F&& f)
+{
+    std::vector<std::thread> pool;
+    for(std::size_t t = 0; t != threads; ++t)
+    {
+        pool.emplace_back([&f, t] { f(t); });
+    }
+    for(auto& th : pool)
+    {
+        th.join();
+    }
+}
+
+}
+
+BENCHMARK("concurrent")
+{
+    double insert1 = 0, lookup1 = 0;
+    for(std::size_t threads : {1, 2, 4, 8, 16})
+    {
+        const auto in = shuffled(threads);
+        const auto suffix = "/" + std::to_string(threads);
+
+        std::unique_ptr<interner_t> i;
+        r.run("insert" + suffix, threads * bench::words().size(), [&]
+        {
+            // The sample traits carve a static buffer: start over
+            i.reset();
+            traits::_off().store(0);
+            i = std::make_unique<interner_t>();
+        }, [&]
+        {
+            in_threads(threads, [&i, &in](std::size_t t)
+            {
+                for(auto s : in[t])
+                {
+                    bench::do_not_optimize(i->far(s.data(), s.size()));
+                }
+            });
+        });
+        const auto insert = r.results().back().value;
+
+        r.run("lookup" + suffix, threads * kLookupsPerThread, [&]
+        {
+            in_threads(threads, [&i, &in](std::size_t t)
+            {
+                const auto& w = in[t];
+                for(std::size_t n = 0; n != kLookupsPerThread; ++n)
+                {
+                    const auto s = w[n % w.size()];
+                    bench::do_not_optimize(i->far(s.data(), s.size()));
+                }
+            });
+        });
+        const auto lookup = r.results().back().value;
+
+        if(threads == 1)
+        {
+            insert1 = insert;
+            lookup1 = lookup;
+        }
+        r.report("insert" + suffix + "/speedup", threads, insert1 / insert, "x");
+        r.report("lookup" + suffix + "/speedup", threads, lookup1 / lookup, "x");
+    }
+}
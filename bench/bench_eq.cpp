@@ -0,0 +1,105 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2019 jh0x
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "bench.h"
+
+#include <intern/default_string_traits.hpp>
+
+#include <cstring>
+
+namespace x = intern;
+
+// Traits::eq vs memcmp on equal and unequal pairs of the same length
+
+namespace
+{
+
+constexpr std::size_t kPairs = 1024;
+
+struct pairs
+{
+    std::vector<std::string> a, b;
+};
+
+// Unequal pairs differ in one random position
+pairs make_pairs(std::size_t len, bool equal)
+{
+    bench::lcg rnd{len};
+    pairs p;
+    for(std::size_t i = 0; i != kPairs; ++i)
+    {
+        std::string s(len, ' ');
+        for(auto& c : s)
+        {
+            c = static_cast<char>('a' + rnd() % 26);
+        }
+        p.a.push_back(s);
+        if(!equal && len)
+        {
+            s[rnd() % len] ^= 0x20;
+        }
+        p.b.push_back(s);
+    }
+    return p;
+}
+
+template<typename F>
+void run_pairs(bench::runner& r, const std::string& name, const pairs& p, F f)
+{
+    constexpr std::size_t kRounds = 256;
+    r.run(name, kPairs * kRounds, [&]
+    {
+        std::size_t n = 0;
+        for(std::size_t k = 0; k != kRounds; ++k)
+        {
+            for(std::size_t i = 0; i != kPairs; ++i)
+            {
+                n += f(p.a[i].data(), p.b[i].data(), p.a[i].size());
+            }
+        }
+        bench::do_not_optimize(n);
+    });
+}
+
+}
+
+BENCHMARK("eq")
+{
+    for(std::size_t len : {4, 8, 12, 16, 24, 32, 48, 64, 128})
+    {
+        for(bool equal : {true, false})
+        {
+            const auto p = make_pairs(len, equal);
+            const auto suffix = std::to_string(len) + (equal ? "/eq" : "/ne");
+            run_pairs(r, "memcmp/" + suffix, p,
+                    [](const char* a, const char* b, std::size_t l)
+                    {
+                        return std::memcmp(a, b, l) == 0;
+                    });
+            run_pairs(r, "eq/" + suffix, p,
+                    [](const char* a, const char* b, std::size_t l)
+                    {
+                        return x::default_string_traits::eq(a, b, l);
+                    });
+        }
+    }
+}
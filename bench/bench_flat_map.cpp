@@ -0,0 +1,110 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2019 jh0x
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "bench.h"
+
+#include <intern/flat_map.hpp>
+#include <intern/interner.hpp>
+
+namespace x = intern;
+
+// Counting words.txt keyed by interned strings: intern::flat_map vs phmap
+// hashing the characters (as hash_value does in the tests) and phmap
+// hashing the pointer
+
+namespace
+{
+
+constexpr std::size_t kRounds = 64;
+
+using interner_t = x::interner<x::interner_sample_arena_traits<>>;
+using stringF = interner_t::stringF;
+using stringST = interner_t::stringST;
+
+template<typename StringT>
+struct content_hash
+{
+    std::size_t operator()(const StringT& s) const noexcept
+    {
+        return x::fast_hash{}(s.data(), s.size());
+    }
+};
+template<typename K, typename H>
+using phmap_t = phmap::parallel_flat_hash_map<K, int, H, phmap::EqualTo<K>,
+      phmap::Allocator<std::pair<const K, int>>, 0>;
+
+struct pointer_hash
+{
+    std::size_t operator()(stringF s) const noexcept
+    {
+        return x::details::mix64(reinterpret_cast<std::uintptr_t>(s.data()));
+    }
+};
+
+template<typename Map, typename StringT>
+void measure(bench::runner& r, const std::string& name,
+        const std::vector<StringT>& keys)
+{
+    Map m;
+    r.run(name + "/insert", keys.size(), [&] { m = Map{}; }, [&]
+    {
+        for(const auto& k : keys)
+        {
+            ++m[k];
+        }
+    });
+    r.run(name + "/find", keys.size() * kRounds, [&]
+    {
+        std::size_t n = 0;
+        for(std::size_t round = 0; round != kRounds; ++round)
+        {
+            for(const auto& k : keys)
+            {
+                n += m.find(k)->second;
+            }
+        }
+        bench::do_not_optimize(n);
+    });
+}
+
+}
+
+BENCHMARK("flat_map")
+{
+    interner_t i;
+    std::vector<stringF> far;
+    std::vector<stringST> tiny;
+    for(auto& s : bench::words())
+    {
+        far.push_back(i.far(s));
+        tiny.push_back(i.tiny(s));
+    }
+
+    measure<x::flat_map<stringF, int>>(r, "far/flat_map", far);
+    measure<phmap_t<stringF, content_hash<stringF>>>(
+            r, "far/phmap", far);
+    measure<phmap_t<stringF, pointer_hash>>(
+            r, "far/phmap_ptr", far);
+    measure<x::flat_map<stringST, int>>(r, "tiny/flat_map", tiny);
+    measure<phmap_t<stringST, content_hash<stringST>>>(
+            r, "tiny/phmap", tiny);
+}
@@ -0,0 +1,114 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2019 jh0x
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "bench.h"
+
+#include <intern/interner.hpp>
+
+#include <string_view>
+#include <thread>
+
+namespace x = intern;
+
+// Threads hammering a shared interner with a skewed workload: 90% of the
+// lookups go to 500 hot strings, the rest to 100k others. With the front
+// cache the hot strings no longer go to the shared submaps.
+
+namespace
+{
+
+constexpr std::size_t kArena = 1 << 26;
+constexpr std::size_t kOpsPerThread = 1 << 18;
+
+std::vector<std::vector<std::string_view>> skewed(
+        const std::vector<std::string>& strings, std::size_t threads)
+{
+    std::vector<std::vector<std::string_view>> out(threads);
+    for(std::size_t t = 0; t != threads; ++t)
+    {
+        bench::lcg rnd{t + 1};
+        for(std::size_t n = 0; n != kOpsPerThread; ++n)
+        {
+            const auto hot = rnd() % 10 != 0;
+            out[t].push_back(strings[rnd() % (hot ? 500 : strings.size())]);
+        }
+    }
+    return out;
+}
+
+template<typename ITraits>
+void run_threads(bench::runner& r, const std::string& name,
+        const std::vector<std::string>& strings, std::size_t threads)
+{
+    using interner_t = x::interner<ITraits>;
+    interner_t i;
+    for(auto& s : strings)
+    {
+        i.far(s);
+    }
+    const auto in = skewed(strings, threads);
+    [[maybe_unused]] x::details::front_cache_stats before{};
+    if constexpr(x::details::front_cache_size<ITraits>::value != 0)
+    {
+        before = interner_t::front_cache_stats();
+    }
+    r.run(name + "/" + std::to_string(threads), threads * kOpsPerThread, [&]
+    {
+        std::vector<std::thread> pool;
+        for(std::size_t t = 0; t != threads; ++t)
+        {
+            pool.emplace_back([&i, &w = in[t]]
+            {
+                for(auto s : w)
+                {
+                    bench::do_not_optimize(i.far(s.data(), s.size()));
+                }
+            });
+        }
+        for(auto& th : pool)
+        {
+            th.join();
+        }
+    });
+    if constexpr(x::details::front_cache_size<ITraits>::value != 0)
+    {
+        const auto after = interner_t::front_cache_stats();
+        const auto hits = after.hits - before.hits;
+        const auto misses = after.misses - before.misses;
+        r.report(name + "/" + std::to_string(threads) + "/hit_rate",
+                hits + misses, 100.0 * double(hits) / double(hits + misses), "%");
+    }
+}
+
+}
+
+BENCHMARK("front_cache")
+{
+    const auto strings = bench::unique_strings(100000);
+    using shared = x::interner_sample_concurrent_traits<kArena>;
+    using cached = x::interner_sample_cached_traits<kArena>;
+    for(std::size_t threads : {1, 2, 4, 8})
+    {
+        run_threads<shared>(r, "shared", strings, threads);
+        run_threads<cached>(r, "cached", strings, threads);
+    }
+}
@@ -0,0 +1,157 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2019 jh0x
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "bench.h"
+
+#include <intern/hash.hpp>
+#include <intern/interner.hpp>
+
+#include <functional>
+#include <string_view>
+
+namespace x = intern;
+
+// The bundled fast_hash vs std::hash, which interner_sample_hash used to
+// forward to
+
+namespace
+{
+
+struct std_hash
+{
+    std::size_t operator()(const char* s, std::size_t l) const noexcept
+    {
+        return std::hash<std::string_view>{}(std::string_view(s, l));
+    }
+};
+
+constexpr std::size_t kArena = 1 << 26;
+
+// Request paths with a query string: 40 to 200 bytes
+std::vector<std::string> urls(std::size_t n)
+{
+    const auto& w = bench::words();
+    bench::lcg rnd{7};
+    std::vector<std::string> out;
+    out.reserve(n);
+    for(std::size_t i = 0; i != n; ++i)
+    {
+        std::string u = "https://api.example.com/v2";
+        const auto segments = 1 + rnd() % 6;
+        for(std::size_t s = 0; s != segments; ++s)
+        {
+            u += '/';
+            u += w[rnd() % w.size()];
+        }
+        u += "?id=" + std::to_string(i) + "&session=" + std::to_string(rnd());
+        out.push_back(std::move(u));
+    }
+    return out;
+}
+
+template<typename H>
+void hash_all(bench::runner& r, const std::string& name,
+        const std::vector<std::string>& in)
+{
+    std::size_t bytes = 0;
+    for(auto& s : in)
+    {
+        bytes += s.size();
+    }
+    const std::size_t rounds = std::max<std::size_t>(1, (1 << 24) / bytes);
+    r.run(name, in.size() * rounds, [&]
+    {
+        std::size_t acc = 0;
+        for(std::size_t k = 0; k != rounds; ++k)
+        {
+            for(auto& s : in)
+            {
+                acc += H{}(s.data(), s.size());
+            }
+        }
+        bench::do_not_optimize(acc);
+    });
+    r.report(name + "/avg_len", in.size(), double(bytes) / in.size(), "B");
+}
+
+template<typename H>
+void far_all(bench::runner& r, const std::string& name,
+        const std::vector<std::string>& in)
+{
+    using traits = bench::bench_traits<kArena, H>;
+    using interner_t = x::interner<traits>;
+    traits::raze();
+    interner_t i;
+    for(auto& s : in)
+    {
+        i.far(s);
+    }
+    r.run(name, in.size(), [&]
+    {
+        for(auto& s : in)
+        {
+            bench::do_not_optimize(i.far(s.data(), s.size()));
+        }
+    });
+}
+
+std::vector<std::string> blobs(std::size_t n, std::size_t len)
+{
+    bench::lcg rnd{3};
+    std::vector<std::string> out(n, std::string(len, ' '));
+    for(auto& s : out)
+    {
+        for(auto& c : s)
+        {
+            c = static_cast<char>('!' + rnd() % 90);
+        }
+    }
+    return out;
+}
+
+}
+
+BENCHMARK("hash/words")
+{
+    const auto& w = bench::words();
+    hash_all<std_hash>(r, "std", w);
+    hash_all<x::fast_hash>(r, "fast", w);
+    far_all<std_hash>(r, "far_hit/std", w);
+    far_all<x::fast_hash>(r, "far_hit/fast", w);
+}
+
+BENCHMARK("hash/urls")
+{
+    const auto u = urls(1 << 16);
+    hash_all<std_hash>(r, "std", u);
+    hash_all<x::fast_hash>(r, "fast", u);
+    far_all<std_hash>(r, "far_hit/std", u);
+    far_all<x::fast_hash>(r, "far_hit/fast", u);
+}
+
+BENCHMARK("hash/4k")
+{
+    // Bulk throughput of the vector loop
+    const auto b = blobs(256, 4096);
+    hash_all<std_hash>(r, "std", b);
+    hash_all<x::fast_hash>(r, "fast", b);
+}
@@ -0,0 +1,107 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2019 jh0x
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "bench.h"
+
+#include <intern/interner.hpp>
+
+#include <random>
+
+namespace x = intern;
+
+// A 4M row column over a 64k symbol vocabulary: string_far (8 bytes a row)
+// vs string_id (4 bytes), and a per-symbol aggregate kept in a hash map
+// keyed by the string vs a vector indexed by the id.
+
+namespace
+{
+
+constexpr std::size_t kRows = 1 << 22;
+constexpr std::size_t kSymbols = 1 << 16;
+
+struct id_string_traits : x::default_string_traits
+{
+    constexpr static auto metadata_store_id = true;
+};
+
+}
+
+BENCHMARK("ids")
+{
+    using interner_t = x::interner<
+        x::interner_sample_arena_traits<>, id_string_traits>;
+    using stringF = interner_t::stringF;
+    interner_t i;
+
+    const auto vocabulary = bench::unique_strings(kSymbols);
+    std::mt19937 rng{42};
+    std::vector<stringF> far_column;
+    std::vector<x::string_id> id_column;
+    far_column.reserve(kRows);
+    id_column.reserve(kRows);
+    for(std::size_t n = 0; n != kRows; ++n)
+    {
+        const auto f = i.far(vocabulary[rng() % kSymbols]);
+        far_column.push_back(f);
+        id_column.push_back(f.id());
+    }
+    r.report("column/far", kRows,
+            double(far_column.size() * sizeof(stringF)) / (1 << 20), "MB");
+    r.report("column/id", kRows,
+            double(id_column.size() * sizeof(x::string_id)) / (1 << 20), "MB");
+
+    // Rows per symbol
+    r.run("count/hash_map", kRows, [&]
+    {
+        phmap::flat_hash_map<const char*, std::uint64_t> counts;
+        for(const auto f : far_column)
+        {
+            ++counts[f.data()];
+        }
+        bench::do_not_optimize(counts.size());
+    });
+    r.run("count/vector", kRows, [&]
+    {
+        std::vector<std::uint64_t> counts(i.size());
+        for(const auto id : id_column)
+        {
+            ++counts[id.value()];
+        }
+        bench::do_not_optimize(counts.data());
+    });
+
+    // Both ways
+    r.run("far->id", kRows, [&]
+    {
+        for(const auto f : far_column)
+        {
+            bench::do_not_optimize(f.id());
+        }
+    });
+    r.run("id->far", kRows, [&]
+    {
+        for(const auto id : id_column)
+        {
+            bench::do_not_optimize(i.far(id));
+        }
+    });
+}
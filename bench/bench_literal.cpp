@@ -0,0 +1,81 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2019 jh0x
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "bench.h"
+
+#include <intern/interner.hpp>
+
+namespace x = intern;
+
+// Interning the same literal over and over: far("NYSE") hashes and probes
+// every time, INTERN_LITERAL only reads the slot of its call site
+
+namespace
+{
+
+constexpr std::size_t kCalls = 1 << 22;
+
+}
+
+BENCHMARK("literal")
+{
+    x::interner<x::interner_sample_arena_traits<>> i;
+    for(auto& s : bench::words())
+    {
+        i.far(s);
+    }
+
+    r.run("far", kCalls, [&]
+    {
+        for(std::size_t k = 0; k != kCalls; ++k)
+        {
+            bench::do_not_optimize(i.far("NYSE"));
+        }
+    });
+    r.run("INTERN_LITERAL", kCalls, [&]
+    {
+        for(std::size_t k = 0; k != kCalls; ++k)
+        {
+            bench::do_not_optimize(INTERN_LITERAL(i, "NYSE"));
+        }
+    });
+
+    const auto nyse = i.far("NYSE");
+    r.run("compare/far", kCalls, [&]
+    {
+        std::size_t n = 0;
+        for(std::size_t k = 0; k != kCalls; ++k)
+        {
+            n += i.far("NYSE") == nyse;
+        }
+        bench::do_not_optimize(n);
+    });
+    r.run("compare/INTERN_LITERAL", kCalls, [&]
+    {
+        std::size_t n = 0;
+        for(std::size_t k = 0; k != kCalls; ++k)
+        {
+            n += INTERN_LITERAL(i, "NYSE") == nyse;
+        }
+        bench::do_not_optimize(n);
+    });
+}
@@ -0,0 +1,168 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2019 jh0x
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "bench.h"
+
+#include <intern/interner.hpp>
+#include <intern/suffix_report.hpp>
+
+namespace x = intern;
+
+// Index memory per interned string: phmap lookup vs compact index
+
+namespace
+{
+
+constexpr std::size_t kArena = 1 << 26;
+using normal_traits = bench::bench_traits<kArena>;
+using compact_traits = bench::bench_compact_traits<kArena>;
+
+template<typename Interner>
+void measure(bench::runner& r, const std::string& name,
+        const std::vector<std::string>& in)
+{
+    normal_traits::raze();
+    Interner i;
+    for(auto& s : in)
+    {
+        i.far(s);
+    }
+    const double n = i.size();
+    r.report(name + "/index", i.size(), i.index_bytes() / n, "B/string");
+    r.report(name + "/arena", i.size(), normal_traits::used() / n, "B/string");
+
+    r.run(name + "/far_hit", in.size(), [&]
+    {
+        for(auto& s : in)
+        {
+            bench::do_not_optimize(i.far(s));
+        }
+    });
+}
+
+}
+
+BENCHMARK("memory/words")
+{
+    const auto& w = bench::words();
+    measure<x::interner<normal_traits>>(r, "phmap", w);
+    measure<x::interner<compact_traits>>(r, "compact", w);
+}
+
+BENCHMARK("memory/1M")
+{
+    const auto w = bench::unique_strings(1 << 20);
+    measure<x::interner<normal_traits>>(r, "phmap", w);
+    measure<x::interner<compact_traits>>(r, "compact", w);
+}
+
+// Length headers: 1M short strings plus a few 256 KiB blobs, with a 32 bit
+// size_type vs short sizes (2 bytes, wide only for the blobs)
+namespace
+{
+
+struct wide_traits : x::default_string_traits
+{
+    using size_type = std::uint32_t;
+};
+struct short_traits : wide_traits
+{
+    constexpr static auto metadata_short_size = true;
+};
+
+template<typename STraits>
+void measure_sizes(bench::runner& r, const std::string& name,
+        const std::vector<std::string>& in)
+{
+    x::interner<x::interner_sample_arena_traits<>, STraits> i;
+    std::vector<typename decltype(i)::stringF> column;
+    column.reserve(in.size());
+    for(auto& s : in)
+    {
+        column.push_back(i.far(s));
+    }
+    r.report(name + "/arena", i.size(),
+            double(i.allocator().used()) / (1 << 20), "MB");
+    r.run(name + "/size", column.size(), [&]
+    {
+        std::size_t total = 0;
+        for(const auto f : column)
+        {
+            total += f.size();
+        }
+        bench::do_not_optimize(total);
+    });
+}
+
+}
+
+BENCHMARK("memory/sizes")
+{
+    auto in = bench::unique_strings(1 << 20);
+    for(char c = 'a'; c != 'a' + 16; ++c)
+    {
+        in.push_back(std::string(1 << 18, c));
+    }
+    measure_sizes<wide_traits>(r, "size32", in);
+    measure_sizes<short_traits>(r, "short", in);
+}
+
+// What sharing tails would save (see suffix_report): the words, currency
+// pairs and path-like keys
+BENCHMARK("memory/suffixes")
+{
+    const auto report = [&r](const std::string& name,
+            const std::vector<std::string>& in)
+    {
+        const auto st = x::suffix_report(in);
+        r.report(name + "/strings", st.strings, double(st.strings), "");
+        r.report(name + "/suffixes", st.strings, double(st.suffixes), "");
+        r.report(name + "/bytes", st.strings, double(st.bytes), "B");
+        r.report(name + "/shared", st.strings, double(st.shared_bytes), "B");
+        r.report(name + "/saved", st.strings,
+                100.0 * double(st.shared_bytes) / double(st.bytes), "%");
+    };
+    report("words", bench::words());
+
+    const char* ccy[] = {"USD", "EUR", "GBP", "JPY", "CHF", "AUD", "CAD",
+        "NZD", "SEK", "NOK"};
+    std::vector<std::string> pairs(std::begin(ccy), std::end(ccy));
+    for(auto* a : ccy)
+    {
+        for(auto* b : ccy)
+        {
+            pairs.push_back(std::string(a) + b);
+        }
+    }
+    report("ccy", pairs);
+
+    std::vector<std::string> paths;
+    const auto& w = bench::words();
+    for(std::size_t k = 0; k + 2 < w.size(); k += 3)
+    {
+        const auto leaf = w[k + 2] + ".json";
+        paths.push_back(leaf);
+        paths.push_back(w[k + 1] + "/" + leaf);
+        paths.push_back(w[k] + "/" + w[k + 1] + "/" + leaf);
+    }
+    report("paths", paths);
+}
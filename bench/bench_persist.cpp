@@ -0,0 +1,69 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2019 jh0x
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "bench.h"
+
+#include <intern/interner.hpp>
+
+#include <cstdio>
+
+namespace x = intern;
+
+// Cold start (interning everything) vs warm start (load() of a file
+// written by save(), then the first far() of every string)
+
+BENCHMARK("persist")
+{
+    using traits = x::interner_sample_arena_traits<>;
+    using interner_t = x::interner<traits>;
+    const char* file = "bench_persist.intern";
+    const auto in = bench::unique_strings(1 << 20);
+
+    std::unique_ptr<interner_t> i;
+    r.run("cold", in.size(), [&] { i.reset(new interner_t); }, [&]
+    {
+        for(auto& s : in)
+        {
+            bench::do_not_optimize(i->far(s));
+        }
+    });
+    r.run("save", in.size(), [&] { i->save(file); });
+
+    r.run("load", 1, [&] { i.reset(new interner_t); }, [&]
+    {
+        i->load(file);
+    });
+    r.run("warm", in.size(), [&]
+    {
+        i.reset(new interner_t);
+        i->load(file);
+    }, [&]
+    {
+        for(auto& s : in)
+        {
+            bench::do_not_optimize(i->far(s));
+        }
+    });
+    r.report("warm/allocated", in.size(), double(i->allocator().used()), "B");
+    i.reset();
+    std::remove(file);
+}
@@ -0,0 +1,89 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2019 jh0x
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "bench.h"
+
+#include <intern/interner.hpp>
+
+#include <algorithm>
+#include <random>
+
+namespace x = intern;
+
+// Sorting a column of interned instrument names over and over: byte
+// comparisons vs ranks (Traits::metadata_store_rank), plus the cost of
+// keeping the ranks while interning
+
+namespace
+{
+
+constexpr std::size_t kNames = 1 << 17;
+constexpr std::size_t kRows = 1 << 20;
+
+struct ranked_traits : x::default_string_traits
+{
+    constexpr static auto metadata_store_rank = true;
+};
+
+template<typename STraits>
+void measure(bench::runner& r, const std::string& name,
+        const std::vector<std::string>& names)
+{
+    using interner_t = x::interner<x::interner_sample_arena_traits<>, STraits>;
+    std::unique_ptr<interner_t> i;
+    r.run(name + "/intern", names.size(), [&] { i.reset(new interner_t); }, [&]
+    {
+        for(auto& s : names)
+        {
+            i->far(s);
+        }
+    });
+
+    std::mt19937 rng{1};
+    std::vector<typename interner_t::stringF> column;
+    column.reserve(kRows);
+    for(std::size_t k = 0; k != kRows; ++k)
+    {
+        column.push_back(i->far(names[rng() % names.size()]));
+    }
+    auto rows = column;
+    r.run(name + "/sort", kRows, [&] { rows = column; }, [&]
+    {
+        std::sort(rows.begin(), rows.end());
+    });
+}
+
+}
+
+BENCHMARK("rank")
+{
+    // Long shared prefixes, like option symbols
+    std::vector<std::string> names;
+    std::mt19937 rng{42};
+    for(std::size_t k = 0; k != kNames; ++k)
+    {
+        names.push_back("OPT.US.EQ." + std::to_string(rng() % 5000)
+                + ".2026-12-18." + std::to_string(rng() % 100000));
+    }
+    measure<x::default_string_traits>(r, "bytes", names);
+    measure<ranked_traits>(r, "ranked", names);
+}
@@ -0,0 +1,114 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2019 jh0x
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "bench.h"
+
+#include <intern/interner.hpp>
+
+#include <deque>
+
+namespace x = intern;
+
+// Churn: a window of 50k live order ids, every step interns a new one and
+// drops the oldest. Append-only interners grow with every id ever seen,
+// the reclaiming one stays at the size of the window.
+
+namespace
+{
+
+constexpr std::size_t kWindow = 50000;
+constexpr std::size_t kSteps = 1 << 20;
+
+std::string order_id(std::size_t n)
+{
+    return "ORD-20261018-" + std::to_string(n * 2654435761ULL % 1000000007);
+}
+
+}
+
+BENCHMARK("reclaim")
+{
+    std::vector<std::string> ids;
+    ids.reserve(kSteps);
+    for(std::size_t n = 0; n != kSteps; ++n)
+    {
+        ids.push_back(order_id(n));
+    }
+
+    using append_t = x::interner<x::interner_sample_arena_traits<>>;
+    using reclaim_t = x::interner<x::interner_sample_reclaim_traits>;
+    std::unique_ptr<append_t> a;
+    std::unique_ptr<reclaim_t> c;
+
+    r.run("append/step", kSteps, [&] { a.reset(new append_t); }, [&]
+    {
+        std::deque<append_t::stringF> live;
+        for(auto& s : ids)
+        {
+            live.push_back(a->far(s));
+            if(live.size() > kWindow)
+            {
+                live.pop_front();
+            }
+        }
+    });
+    r.run("reclaim/step", kSteps, [&] { c.reset(new reclaim_t); }, [&]
+    {
+        std::deque<reclaim_t::refT> live;
+        for(auto& s : ids)
+        {
+            live.push_back(c->ref(s));
+            if(live.size() > kWindow)
+            {
+                live.pop_front();
+            }
+        }
+    });
+
+    r.report("append/strings", kSteps, double(a->size()), "");
+    r.report("append/arena", kSteps,
+            double(a->allocator().used()) / (1 << 20), "MB");
+    r.report("append/index", kSteps, double(a->index_bytes()) / (1 << 20), "MB");
+
+    // Steady state for the window
+    c.reset(new reclaim_t);
+    std::deque<reclaim_t::refT> live;
+    for(std::size_t n = 0; n != kSteps; ++n)
+    {
+        live.push_back(c->ref(ids[n]));
+        if(live.size() > kWindow)
+        {
+            live.pop_front();
+        }
+        if(n == kWindow * 2)
+        {
+            r.report("reclaim/arena@100k", n,
+                    double(c->allocator().used()) / (1 << 20), "MB");
+        }
+    }
+    r.report("reclaim/strings", kSteps, double(c->size()), "");
+    r.report("reclaim/arena", kSteps,
+            double(c->allocator().used()) / (1 << 20), "MB");
+    r.report("reclaim/index", kSteps, double(c->index_bytes()) / (1 << 20), "MB");
+    live.clear();
+    c.reset();
+}
@@ -0,0 +1,102 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2019 jh0x
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "bench.h"
+
+#include <intern/interner.hpp>
+#include <intern/scoped_interner.hpp>
+
+namespace x = intern;
+
+// Requests interning 10 well known strings and 20 one-off ones: all into
+// the global interner vs a scope rolled back after every request
+
+namespace
+{
+
+constexpr std::size_t kRequests = 1 << 16;
+constexpr std::size_t kKnown = 10;
+constexpr std::size_t kTemporary = 20;
+
+}
+
+BENCHMARK("scoped")
+{
+    using interner_t = x::interner<x::interner_sample_arena_traits<>>;
+    const auto& w = bench::words();
+    std::vector<std::string> temporary;
+    for(std::size_t n = 0; n != kRequests * kTemporary; ++n)
+    {
+        temporary.push_back("req-" + std::to_string(n / kTemporary)
+                + "-field-" + std::to_string(n % kTemporary));
+    }
+
+    std::unique_ptr<interner_t> global;
+    r.run("global", kRequests, [&]
+    {
+        global.reset(new interner_t);
+        for(auto& s : w)
+        {
+            global->far(s);
+        }
+    }, [&]
+    {
+        for(std::size_t q = 0; q != kRequests; ++q)
+        {
+            for(std::size_t k = 0; k != kKnown; ++k)
+            {
+                bench::do_not_optimize(global->far(w[(q + k) % w.size()]));
+            }
+            for(std::size_t k = 0; k != kTemporary; ++k)
+            {
+                bench::do_not_optimize(global->far(temporary[q * kTemporary + k]));
+            }
+        }
+    });
+    r.report("global/arena", kRequests,
+            double(global->allocator().used()) / (1 << 20), "MB");
+
+    interner_t parent;
+    for(auto& s : w)
+    {
+        parent.far(s);
+    }
+    x::scoped_interner<interner_t> scope{parent};
+    r.run("scoped", kRequests, [&]
+    {
+        for(std::size_t q = 0; q != kRequests; ++q)
+        {
+            const auto m = scope.mark();
+            for(std::size_t k = 0; k != kKnown; ++k)
+            {
+                bench::do_not_optimize(scope.far(w[(q + k) % w.size()]));
+            }
+            for(std::size_t k = 0; k != kTemporary; ++k)
+            {
+                bench::do_not_optimize(scope.far(temporary[q * kTemporary + k]));
+            }
+            scope.rollback(m);
+        }
+    });
+    r.report("scoped/arena", kRequests,
+            double(scope.allocator().reserved()) / 1024, "KB");
+}
@@ -0,0 +1,90 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2019 jh0x
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "bench.h"
+
+#include <intern/interner.hpp>
+#include <intern/sort.hpp>
+
+#include <algorithm>
+#include <thread>
+
+namespace x = intern;
+
+// Sorting words.txt scaled up to 10M rows: std::sort vs intern::sort on
+// one thread and on all of them
+
+namespace
+{
+
+constexpr std::size_t kRows = 10000000;
+
+using interner_t = x::interner<x::interner_sample_arena_traits<>>;
+
+template<typename StringT, typename Intern>
+void measure(bench::runner& r, const std::string& name, Intern intern)
+{
+    const auto& w = bench::words();
+    std::vector<StringT> column;
+    column.reserve(kRows);
+    for(std::size_t k = 0; k != kRows; ++k)
+    {
+        column.push_back(intern(w[k * 7919 % w.size()]));
+    }
+    auto rows = column;
+    const auto threads = std::max(1u, std::thread::hardware_concurrency());
+    r.run(name + "/std::sort", kRows, [&] { rows = column; }, [&]
+    {
+        std::sort(rows.begin(), rows.end());
+    });
+    r.run(name + "/intern::sort", kRows, [&] { rows = column; }, [&]
+    {
+        x::sort(rows.begin(), rows.end());
+    });
+    r.run(name + "/intern::sort/threads", kRows, [&] { rows = column; }, [&]
+    {
+        x::sort(rows.begin(), rows.end(), threads);
+    });
+}
+
+}
+
+BENCHMARK("sort")
+{
+    interner_t i;
+    measure<interner_t::stringF>(r, "far", [&](const std::string& s)
+    {
+        return i.far(s);
+    });
+    measure<interner_t::stringST>(r, "tiny", [&](const std::string& s)
+    {
+        return i.tiny(s);
+    });
+    measure<interner_t::stringS1<16>>(r, "sso1<16>", [&](const std::string& s)
+    {
+        return i.sso1<16>(s);
+    });
+    measure<interner_t::stringS2<24>>(r, "sso2<24>", [&](const std::string& s)
+    {
+        return i.sso2<24>(s);
+    });
+}
@@ -0,0 +1,97 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2019 jh0x
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "bench.h"
+
+#include <intern/interner.hpp>
+
+#include <algorithm>
+
+namespace x = intern;
+
+// string_sso_v2 (self-pointer, custom copy) vs string_sso_v3 (offset,
+// trivially copyable) of the same size: copying a column, growing a
+// vector, sorting, swapping and reading the characters
+
+namespace
+{
+
+constexpr std::size_t kRows = 1 << 20;
+
+using interner_t = x::interner<x::interner_sample_arena_traits<>>;
+
+template<typename StringT, typename Intern>
+void measure(bench::runner& r, const std::string& name, Intern intern)
+{
+    const auto& w = bench::words();
+    std::vector<StringT> column;
+    column.reserve(kRows);
+    for(std::size_t k = 0; k != kRows; ++k)
+    {
+        column.push_back(intern(w[k * 7919 % w.size()]));
+    }
+
+    std::vector<StringT> rows;
+    r.run(name + "/copy", kRows, [&] { rows.clear(); rows.shrink_to_fit(); }, [&]
+    {
+        rows = column;
+    });
+    r.run(name + "/grow", kRows, [&] { rows = std::vector<StringT>{}; }, [&]
+    {
+        for(const auto& s : column)
+        {
+            rows.push_back(s);
+        }
+    });
+    r.run(name + "/sort", kRows, [&] { rows = column; }, [&]
+    {
+        std::sort(rows.begin(), rows.end());
+    });
+    r.run(name + "/swap", kRows, [&] { rows = column; }, [&]
+    {
+        std::reverse(rows.begin(), rows.end());
+    });
+    r.run(name + "/data", kRows, [&]
+    {
+        std::size_t sum = 0;
+        for(const auto& s : column)
+        {
+            sum += static_cast<unsigned char>(s.data()[0]);
+        }
+        bench::do_not_optimize(sum);
+    });
+}
+
+}
+
+BENCHMARK("sso3")
+{
+    interner_t i;
+    measure<interner_t::stringS2<24>>(r, "sso2<24>", [&](const std::string& s)
+    {
+        return i.sso2<24>(s);
+    });
+    measure<interner_t::stringS3<24>>(r, "sso3<24>", [&](const std::string& s)
+    {
+        return i.sso3<24>(s);
+    });
+}
@@ -0,0 +1,141 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2019 jh0x
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "bench.h"
+
+#include <intern/interner.hpp>
+
+#include <string_view>
+#include <thread>
+
+namespace x = intern;
+
+// Price of ITraits::statistics on far(): hits and misses on one thread,
+// then threads sharing a concurrent interner (one counter stripe each),
+// and the cost of a snapshot.
+
+namespace
+{
+
+constexpr std::size_t kArena = 1 << 26;
+constexpr std::size_t kOpsPerThread = 1 << 18;
+
+template<typename Base>
+struct counted : Base
+{
+    constexpr static auto statistics = true;
+};
+
+// Distinct types: the concurrent samples carve one static buffer per type
+template<std::size_t N>
+struct shared_traits : x::interner_sample_concurrent_traits<kArena + N> {};
+
+template<typename ITraits>
+void run_single(bench::runner& r, const std::string& name,
+        const std::vector<std::string>& strings)
+{
+    r.run(name + "/miss", strings.size(), [&]
+    {
+        x::interner<ITraits> i;
+        for(auto& s : strings)
+        {
+            bench::do_not_optimize(i.far(s));
+        }
+    });
+    x::interner<ITraits> i;
+    for(auto& s : strings)
+    {
+        i.far(s);
+    }
+    r.run(name + "/hit", strings.size(), [&]
+    {
+        for(auto& s : strings)
+        {
+            bench::do_not_optimize(i.far(s));
+        }
+    });
+}
+
+template<typename ITraits>
+void run_threads(bench::runner& r, const std::string& name,
+        const std::vector<std::string>& strings, std::size_t threads)
+{
+    x::interner<ITraits> i;
+    std::vector<std::vector<std::string_view>> in(threads);
+    for(std::size_t t = 0; t != threads; ++t)
+    {
+        bench::lcg rnd{t + 1};
+        for(std::size_t n = 0; n != kOpsPerThread; ++n)
+        {
+            in[t].push_back(strings[rnd() % strings.size()]);
+        }
+    }
+    r.run(name + "/" + std::to_string(threads), threads * kOpsPerThread, [&]
+    {
+        std::vector<std::thread> pool;
+        for(std::size_t t = 0; t != threads; ++t)
+        {
+            pool.emplace_back([&i, &w = in[t]]
+            {
+                for(auto s : w)
+                {
+                    bench::do_not_optimize(i.far(s.data(), s.size()));
+                }
+            });
+        }
+        for(auto& th : pool)
+        {
+            th.join();
+        }
+    });
+}
+
+}
+
+BENCHMARK("stats")
+{
+    const auto strings = bench::unique_strings(100000);
+    using plain = x::interner_sample_arena_traits<>;
+    run_single<plain>(r, "plain", strings);
+    run_single<counted<plain>>(r, "counted", strings);
+
+    for(std::size_t threads : {1, 4})
+    {
+        run_threads<shared_traits<0>>(r, "shared", strings, threads);
+        run_threads<counted<shared_traits<1>>>(r, "shared_counted",
+                strings, threads);
+    }
+
+    x::interner<counted<shared_traits<2>>> i;
+    for(auto& s : strings)
+    {
+        i.far(s);
+    }
+    constexpr std::size_t kSnapshots = 1000;
+    r.run("snapshot", kSnapshots, [&]
+    {
+        for(std::size_t n = 0; n != kSnapshots; ++n)
+        {
+            bench::do_not_optimize(i.stats().lookups);
+        }
+    });
+}
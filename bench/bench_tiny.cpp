@@ -0,0 +1,140 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2019 jh0x
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "bench.h"
+
+#include <intern/interner.hpp>
+#include <intern/details/hash.hpp>
+
+#include <algorithm>
+#include <random>
+
+namespace x = intern;
+
+// string_sso_tiny: whole word ==, < and hash() vs the generic string_common
+// paths (size(), data() and memcmp), on tickers that mostly fit inline
+
+namespace
+{
+
+constexpr std::size_t kRows = 1 << 20;
+
+struct hashed_traits : x::default_string_traits
+{
+    constexpr static auto metadata_store_hash = true;
+};
+using interner_t =
+    x::interner<x::interner_sample_arena_traits<>, hashed_traits>;
+using tiny_t = interner_t::stringST;
+using base_t = x::details::string_common<tiny_t, hashed_traits>;
+
+}
+
+BENCHMARK("tiny")
+{
+    interner_t i;
+    std::mt19937 rng{3};
+    std::vector<std::string> names;
+    for(int k = 0; k != 4000; ++k)
+    {
+        std::string s;
+        const auto len = 1 + rng() % (k % 10 ? 6 : 12);
+        for(std::size_t c = 0; c != len; ++c)
+        {
+            s += char('A' + rng() % 26);
+        }
+        names.push_back(s);
+    }
+    std::vector<tiny_t> a, b;
+    for(std::size_t k = 0; k != kRows; ++k)
+    {
+        a.push_back(i.tiny(names[rng() % names.size()]));
+        b.push_back(i.tiny(names[rng() % 64]));
+    }
+
+    r.run("eq/word", kRows, [&]
+    {
+        std::size_t n = 0;
+        for(std::size_t k = 0; k != kRows; ++k)
+        {
+            n += a[k] == b[k];
+        }
+        bench::do_not_optimize(n);
+    });
+    r.run("eq/generic", kRows, [&]
+    {
+        std::size_t n = 0;
+        for(std::size_t k = 0; k != kRows; ++k)
+        {
+            n += static_cast<const base_t&>(a[k]) == b[k];
+        }
+        bench::do_not_optimize(n);
+    });
+    r.run("less/word", kRows, [&]
+    {
+        std::size_t n = 0;
+        for(std::size_t k = 0; k != kRows; ++k)
+        {
+            n += a[k] < b[k];
+        }
+        bench::do_not_optimize(n);
+    });
+    r.run("less/generic", kRows, [&]
+    {
+        std::size_t n = 0;
+        for(std::size_t k = 0; k != kRows; ++k)
+        {
+            n += static_cast<const base_t&>(a[k])
+                < static_cast<const base_t&>(b[k]);
+        }
+        bench::do_not_optimize(n);
+    });
+    r.run("hash/word", kRows, [&]
+    {
+        std::size_t h = 0;
+        for(const auto& t : b)
+        {
+            h += t.hash();
+        }
+        bench::do_not_optimize(h);
+    });
+    r.run("hash/generic", kRows, [&]
+    {
+        std::size_t h = 0;
+        for(const auto& t : b)
+        {
+            h += x::details::hash_small(t.data(), t.size());
+        }
+        bench::do_not_optimize(h);
+    });
+
+    auto rows = a;
+    r.run("sort/word", kRows, [&] { rows = a; }, [&]
+    {
+        std::sort(rows.begin(), rows.end());
+    });
+    r.run("sort/generic", kRows, [&] { rows = a; }, [&]
+    {
+        std::sort(rows.begin(), rows.end(),
+                [](const base_t& lhs, const base_t& rhs) { return lhs < rhs; });
+    });
+}
@@ -0,0 +1,253 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2019 jh0x
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "bench.h"
+
+#include <intern/flat_map.hpp>
+#include <intern/interner.hpp>
+#include <intern/sort.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <random>
+
+namespace x = intern;
+
+// The same operations for every string type, so that one can be picked
+// for a workload: interning (miss and hit), lookup only, ==, <, hash(),
+// sorting and counting in a hash map. std::string is the baseline.
+// Inputs are words.txt and random strings of a few length distributions;
+// each picks 256K rows out of its distinct strings.
+
+namespace
+{
+
+constexpr std::size_t kRows = 1 << 18;
+
+// Hashes kept by the interner, so that hash() works on every type
+struct hashed_traits : x::default_string_traits
+{
+    constexpr static auto metadata_store_hash = true;
+};
+using interner_t =
+    x::interner<x::interner_sample_arena_traits<>, hashed_traits>;
+
+struct input
+{
+    std::vector<std::string> distinct;
+    std::vector<std::size_t> rows;      // indices into distinct
+    std::vector<std::size_t> pairs;     // random row indices for == and <
+};
+
+input make_input(std::vector<std::string> distinct)
+{
+    std::sort(distinct.begin(), distinct.end());
+    distinct.erase(std::unique(distinct.begin(), distinct.end()),
+            distinct.end());
+    input in;
+    in.distinct = std::move(distinct);
+    std::mt19937_64 rng{7};
+    for(std::size_t k = 0; k != kRows; ++k)
+    {
+        in.rows.push_back(rng() % in.distinct.size());
+        in.pairs.push_back(rng() % kRows);
+    }
+    return in;
+}
+
+// n random lowercase strings with lengths in [lo, hi]
+std::vector<std::string> random_strings(std::size_t n, std::size_t lo,
+        std::size_t hi)
+{
+    std::mt19937_64 rng{lo * 1000 + hi};
+    std::vector<std::string> out;
+    for(std::size_t k = 0; k != n; ++k)
+    {
+        std::string s(lo + rng() % (hi - lo + 1), ' ');
+        for(auto& c : s)
+        {
+            c = static_cast<char>('a' + rng() % 26);
+        }
+        out.push_back(std::move(s));
+    }
+    return out;
+}
+
+template<typename Map, typename StringT, typename Hash, typename Sort>
+void measure_values(bench::runner& r, const std::string& name,
+        const input& in, const std::vector<StringT>& rows, Hash hash,
+        Sort sort)
+{
+    r.run(name + "/eq", kRows, [&]
+    {
+        std::size_t n = 0;
+        for(std::size_t k = 0; k != kRows; ++k)
+        {
+            n += rows[k] == rows[in.pairs[k]];
+        }
+        bench::do_not_optimize(n);
+    });
+    r.run(name + "/less", kRows, [&]
+    {
+        std::size_t n = 0;
+        for(std::size_t k = 0; k != kRows; ++k)
+        {
+            n += rows[k] < rows[in.pairs[k]];
+        }
+        bench::do_not_optimize(n);
+    });
+    r.run(name + "/hash", kRows, [&]
+    {
+        std::size_t h = 0;
+        for(const auto& s : rows)
+        {
+            h += hash(s);
+        }
+        bench::do_not_optimize(h);
+    });
+    auto sorted = rows;
+    r.run(name + "/sort", kRows, [&] { sorted = rows; }, [&]
+    {
+        sort(sorted);
+    });
+    r.run(name + "/map", kRows, [&]
+    {
+        Map counts;
+        for(const auto& s : rows)
+        {
+            ++counts[s];
+        }
+        bench::do_not_optimize(counts.size());
+    });
+}
+
+template<typename StringT, typename Intern>
+void measure_interned(bench::runner& r, const std::string& name,
+        const input& in, Intern intern)
+{
+    std::unique_ptr<interner_t> i;
+    r.run(name + "/intern_miss", in.distinct.size(),
+            [&] { i.reset(new interner_t); }, [&]
+    {
+        for(const auto& s : in.distinct)
+        {
+            bench::do_not_optimize(intern(*i, s));
+        }
+    });
+    r.run(name + "/intern_hit", in.distinct.size(), [&]
+    {
+        for(const auto& s : in.distinct)
+        {
+            bench::do_not_optimize(intern(*i, s));
+        }
+    });
+
+    std::vector<StringT> rows;
+    rows.reserve(kRows);
+    for(const auto k : in.rows)
+    {
+        rows.push_back(intern(*i, in.distinct[k]));
+    }
+    measure_values<x::flat_map<StringT, int>>(r, name, in, rows,
+            [](const StringT& s) { return s.hash(); },
+            [](std::vector<StringT>& v) { x::sort(v); });
+}
+
+void measure_all(bench::runner& r, const input& in)
+{
+    {
+        // Lookup only, without adding: half of the probes are missing
+        interner_t i;
+        std::vector<std::string> probes;
+        for(std::size_t k = 0; k != in.distinct.size(); ++k)
+        {
+            if(k % 2)
+            {
+                i.far(in.distinct[k]);
+            }
+            probes.push_back(in.distinct[k]);
+        }
+        r.run("find", probes.size(), [&]
+        {
+            std::size_t n = 0;
+            for(const auto& s : probes)
+            {
+                n += i.find(s).has_value();
+            }
+            bench::do_not_optimize(n);
+        });
+    }
+
+    {
+        std::vector<std::string> rows;
+        rows.reserve(kRows);
+        for(const auto k : in.rows)
+        {
+            rows.push_back(in.distinct[k]);
+        }
+        r.run("std::string/copy", in.distinct.size(), [&]
+        {
+            std::vector<std::string> v(in.distinct.begin(), in.distinct.end());
+            bench::do_not_optimize(v);
+        });
+        measure_values<phmap::flat_hash_map<std::string, int>>(
+                r, "std::string", in, rows,
+                std::hash<std::string>{},
+                [](std::vector<std::string>& v) { std::sort(v.begin(), v.end()); });
+    }
+
+    measure_interned<interner_t::stringF>(r, "far", in,
+            [](interner_t& i, const std::string& s) { return i.far(s); });
+    measure_interned<interner_t::stringST>(r, "tiny", in,
+            [](interner_t& i, const std::string& s) { return i.tiny(s); });
+    measure_interned<interner_t::stringS1<16>>(r, "sso1<16>", in,
+            [](interner_t& i, const std::string& s) { return i.sso1<16>(s); });
+    measure_interned<interner_t::stringS1<32>>(r, "sso1<32>", in,
+            [](interner_t& i, const std::string& s) { return i.sso1<32>(s); });
+    measure_interned<interner_t::stringS2<24>>(r, "sso2<24>", in,
+            [](interner_t& i, const std::string& s) { return i.sso2<24>(s); });
+    measure_interned<interner_t::stringS3<24>>(r, "sso3<24>", in,
+            [](interner_t& i, const std::string& s) { return i.sso3<24>(s); });
+}
+
+}
+
+BENCHMARK("types/words")
+{
+    measure_all(r, make_input(bench::words()));
+}
+
+BENCHMARK("types/short")
+{
+    measure_all(r, make_input(random_strings(1 << 15, 1, 7)));
+}
+
+BENCHMARK("types/medium")
+{
+    measure_all(r, make_input(random_strings(1 << 15, 8, 24)));
+}
+
+BENCHMARK("types/long")
+{
+    measure_all(r, make_input(random_strings(1 << 15, 32, 128)));
+}
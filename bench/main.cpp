@@ -0,0 +1,141 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2019 jh0x
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "bench.h"
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+namespace
+{
+
+enum class format { table, csv, json };
+
+// Names are plain ASCII, but quotes and backslashes are escaped anyway
+std::string quoted(const std::string& s)
+{
+    std::string out = "\"";
+    for(const char c : s)
+    {
+        if(c == '"' || c == '\\')
+        {
+            out += '\\';
+        }
+        out += c;
+    }
+    return out + '"';
+}
+
+void print(format f, const bench::result& res, bool first)
+{
+    const auto name = res.group + '/' + res.name;
+    switch(f)
+    {
+    case format::table:
+        if(res.unit == "ns/op")
+        {
+            std::printf("%-48s %12zu %12.2f %-10s %12.2f\n",
+                    name.c_str(), res.ops, res.value, res.unit.c_str(),
+                    1e3 / res.value);
+        }
+        else
+        {
+            std::printf("%-48s %12zu %12.2f %-10s\n",
+                    name.c_str(), res.ops, res.value, res.unit.c_str());
+        }
+        break;
+    case format::csv:
+        std::printf("%s,%s,%zu,%.4f,%s\n", quoted(res.group).c_str(),
+                quoted(res.name).c_str(), res.ops, res.value,
+                quoted(res.unit).c_str());
+        break;
+    case format::json:
+        std::printf("%s\n    {\"group\": %s, \"name\": %s, \"n\": %zu, "
+                "\"value\": %.4f, \"unit\": %s}", first ? "" : ",",
+                quoted(res.group).c_str(), quoted(res.name).c_str(), res.ops,
+                res.value, quoted(res.unit).c_str());
+        break;
+    }
+    std::fflush(stdout);
+}
+
+}
+
+// Usage: bench_intern [--csv | --json] [filter]
+//  Runs every benchmark group whose name contains `filter`. The default
+//  output is a table; --csv and --json print one record per measurement
+//  for tracking results over time.
+int main(int argc, char** argv)
+{
+    format f = format::table;
+    const char* filter = "";
+    for(int a = 1; a != argc; ++a)
+    {
+        if(!std::strcmp(argv[a], "--csv"))
+        {
+            f = format::csv;
+        }
+        else if(!std::strcmp(argv[a], "--json"))
+        {
+            f = format::json;
+        }
+        else
+        {
+            filter = argv[a];
+        }
+    }
+
+    switch(f)
+    {
+    case format::table:
+        std::printf("%-48s %12s %12s %-10s %12s\n",
+                "benchmark", "n", "value", "unit", "Mops/s");
+        break;
+    case format::csv:
+        std::printf("group,name,n,value,unit\n");
+        break;
+    case format::json:
+        std::printf("{\"results\": [");
+        break;
+    }
+    bool first = true;
+    for(const auto& g : bench::registry())
+    {
+        if(!std::strstr(g.first, filter))
+        {
+            continue;
+        }
+        bench::runner r{g.first};
+        g.second(r);
+        for(const auto& res : r.results())
+        {
+            print(f, res, first);
+            first = false;
+        }
+    }
+    if(f == format::json)
+    {
+        std::printf("\n]}\n");
+    }
+}
@@ -0,0 +1,330 @@
+#pragma once
+
+// The MIT License (MIT)
+//
+// Copyright (c) 2019 jh0x
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <intern/details/utils.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <utility>
+#include <vector>
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace intern
+{
+
+#ifdef __cpp_exceptions
+[[noreturn]] inline void _bad_alloc() {
+    throw std::bad_alloc{};
+}
+#else
+[[noreturn]] inline void _bad_alloc() noexcept {
+    std::abort();
+}
+#endif
+
+// How arena chunks are backed. Both huge page modes round chunks up to
+// 2MB; explicit ones fall back to transparent ones when the system has no
+// huge pages reserved.
+enum class arena_pages
+{
+    normal,
+    transparent_huge,   // madvise(MADV_HUGEPAGE)
+    explicit_huge,      // MAP_HUGETLB
+};
+
+// Growable bump allocator for interner traits (ITraits::allocatorT).
+// Memory comes in chunks of doubling size and is only released by the
+// destructor, so pointers stay valid for the lifetime of the arena.
+//
+// Chunk k covers the logical offsets [first * (2^k - 1), first * (2^(k+1) - 1)),
+// so an offset maps back to its chunk with one bit scan. Offsets are 32 bit
+// for the compact index: a chunk whose range would end past 4GB is never
+// created, allocate() fails with _bad_alloc() instead. Chunks skipped by a
+// large request still use up their range, so the limit can be reached with
+// less than 4GB actually allocated.
+class arena
+{
+public:
+    constexpr static std::size_t kHugePage = std::size_t(2) << 20;
+
+    explicit arena(std::size_t first_chunk = std::size_t(64) << 10,
+            arena_pages pages = arena_pages::normal) noexcept
+        : _pages{pages}
+    {
+        if(pages != arena_pages::normal && first_chunk < kHugePage)
+        {
+            first_chunk = kHugePage;
+        }
+        _shift = 0;
+        while((std::size_t(1) << _shift) < first_chunk)
+        {
+            ++_shift;
+        }
+    }
+    arena(const arena&) = delete;
+    arena& operator=(const arena&) = delete;
+    arena(arena&& o) noexcept
+        : _chunks{std::move(o._chunks)}
+        , _current{std::exchange(o._current, 0)}
+        , _cur{std::exchange(o._cur, nullptr)}
+        , _end{std::exchange(o._end, nullptr)}
+        , _shift{o._shift}
+        , _pages{o._pages}
+        , _reserved{std::exchange(o._reserved, 0)}
+        , _used{std::exchange(o._used, 0)}
+    {
+        o._chunks.clear();
+    }
+    arena& operator=(arena&& o) noexcept
+    {
+        if(this != &o)
+        {
+            _release();
+            _chunks = std::move(o._chunks);
+            o._chunks.clear();
+            _current = std::exchange(o._current, 0);
+            _cur = std::exchange(o._cur, nullptr);
+            _end = std::exchange(o._end, nullptr);
+            _shift = o._shift;
+            _pages = o._pages;
+            _reserved = std::exchange(o._reserved, 0);
+            _used = std::exchange(o._used, 0);
+        }
+        return *this;
+    }
+    ~arena()
+    {
+        _release();
+    }
+
+    void* allocate(std::size_t s, std::size_t a)
+        noexcept(noexcept(_bad_alloc()))
+    {
+        auto p = (reinterpret_cast<std::uintptr_t>(_cur) + (a - 1)) & -a;
+        if(INTERN__UNLIKELY(
+                    !_cur || p + s > reinterpret_cast<std::uintptr_t>(_end)))
+        {
+            _grow(s + a);
+            p = (reinterpret_cast<std::uintptr_t>(_cur) + (a - 1)) & -a;
+        }
+        char* res = reinterpret_cast<char*>(p);
+        _used += (res + s) - _cur;
+        _cur = res + s;
+        return res;
+    }
+
+    // Logical offset of a pointer returned by allocate()
+    std::uint32_t offset(const char* p) const noexcept
+    {
+        for(std::size_t k = _chunks.size(); k--;)
+        {
+            const auto& c = _chunks[k];
+            if(c._ptr && p >= c._ptr && p < c._ptr + _size(k))
+            {
+                const auto o = _base(k) + std::size_t(p - c._ptr);
+                INTERN__ASSUME(o <= std::uint32_t(-1));
+                return static_cast<std::uint32_t>(o);
+            }
+        }
+        INTERN__ASSUME(false);
+        return 0;
+    }
+    const char* address(std::uint32_t o) const noexcept
+    {
+        const auto k = _chunk_of(o);
+        return _chunks[k]._ptr + (o - _base(k));
+    }
+
+    // Position to come back to with rollback(): everything allocated after
+    // mark() is given back at once, the chunks stay mapped for reuse
+    struct marker
+    {
+        std::size_t _chunk;
+        char* _cur;
+        std::size_t _used;
+    };
+    marker mark() const noexcept { return {_current, _cur, _used}; }
+    void rollback(const marker& m) noexcept
+    {
+        _current = m._chunk;
+        _cur = m._cur;
+        _end = _cur ? _chunks[_current]._ptr + _size(_current) : nullptr;
+        _used = m._used;
+    }
+
+    // Bytes obtained from the system
+    std::size_t reserved() const noexcept { return _reserved; }
+    // Bytes handed out, alignment padding included
+    std::size_t used() const noexcept { return _used; }
+
+private:
+    struct chunk
+    {
+        char* _ptr;
+        std::size_t _mapped;
+    };
+
+    std::size_t _size(std::size_t k) const noexcept
+    {
+        return std::size_t(1) << (_shift + k);
+    }
+    std::size_t _base(std::size_t k) const noexcept
+    {
+        return ((std::size_t(1) << k) - 1) << _shift;
+    }
+    std::size_t _chunk_of(std::size_t o) const noexcept
+    {
+        const auto x = (o >> _shift) + 1;
+        return 63 - __builtin_clzll(x);
+    }
+
+    void _grow(std::size_t need) noexcept(noexcept(_bad_alloc()))
+    {
+        // Chunks left behind by a rollback come first
+        for(auto k = _cur ? _current + 1 : 0; k < _chunks.size(); ++k)
+        {
+            if(_chunks[k]._ptr && _size(k) >= need)
+            {
+                _current = k;
+                _cur = _chunks[k]._ptr;
+                _end = _cur + _size(k);
+                return;
+            }
+        }
+        // Chunks too small for the request keep their offset range but
+        // never get any memory
+        constexpr auto kLimit = std::size_t(1) << 32;
+        auto k = _chunks.size();
+        while(_size(k) < need && _base(k) + _size(k) <= kLimit)
+        {
+            ++k;
+        }
+        // Every offset has to fit in 32 bits
+        if(_base(k) + _size(k) > kLimit)
+        {
+            _bad_alloc();
+        }
+        _chunks.resize(k, chunk{nullptr, 0});
+        const auto size = _size(k);
+        chunk c{nullptr, 0};
+        c._ptr = _map(size, c._mapped);
+        if(!c._ptr)
+        {
+            _bad_alloc();
+        }
+        _current = _chunks.size();
+        _chunks.push_back(c);
+        _reserved += c._mapped;
+        _cur = c._ptr;
+        _end = c._ptr + size;
+    }
+
+    char* _map(std::size_t size, std::size_t& mapped) noexcept
+    {
+#if defined(__linux__)
+        constexpr int prot = PROT_READ | PROT_WRITE;
+        constexpr int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+        const auto huge = (size + kHugePage - 1) & ~(kHugePage - 1);
+#ifdef MAP_HUGETLB
+        if(_pages == arena_pages::explicit_huge)
+        {
+            void* p = ::mmap(nullptr, huge, prot, flags | MAP_HUGETLB, -1, 0);
+            if(p != MAP_FAILED)
+            {
+                mapped = huge;
+                return static_cast<char*>(p);
+            }
+        }
+#endif
+        if(_pages != arena_pages::normal)
+        {
+            // Over-map to get a 2MB aligned range and trim both ends
+            void* p = ::mmap(nullptr, huge + kHugePage, prot, flags, -1, 0);
+            if(p == MAP_FAILED)
+            {
+                return nullptr;
+            }
+            auto* raw = static_cast<char*>(p);
+            auto* aligned = reinterpret_cast<char*>(
+                    (reinterpret_cast<std::uintptr_t>(raw) + kHugePage - 1)
+                    & ~(kHugePage - 1));
+            if(aligned != raw)
+            {
+                ::munmap(raw, aligned - raw);
+            }
+            ::munmap(aligned + huge, (raw + kHugePage) - aligned);
+#ifdef MADV_HUGEPAGE
+            ::madvise(aligned, huge, MADV_HUGEPAGE);
+#endif
+            mapped = huge;
+            return aligned;
+        }
+        void* p = ::mmap(nullptr, size, prot, flags, -1, 0);
+        if(p == MAP_FAILED)
+        {
+            return nullptr;
+        }
+        mapped = size;
+        return static_cast<char*>(p);
+#else
+        // Zeroed like anonymous mappings
+        mapped = size;
+        return static_cast<char*>(std::calloc(size, 1));
+#endif
+    }
+
+    void _release() noexcept
+    {
+        for(auto& c : _chunks)
+        {
+            if(c._ptr)
+            {
+#if defined(__linux__)
+                ::munmap(c._ptr, c._mapped);
+#else
+                std::free(c._ptr);
+#endif
+            }
+        }
+        _chunks.clear();
+        _current = 0;
+        _cur = _end = nullptr;
+        _reserved = _used = 0;
+    }
+
+    std::vector<chunk> _chunks;
+    std::size_t _current = 0;
+    char* _cur = nullptr;
+    char* _end = nullptr;
+    std::size_t _shift;
+    arena_pages _pages;
+    std::size_t _reserved = 0;
+    std::size_t _used = 0;
+};
+
+}
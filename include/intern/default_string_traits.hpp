@@ -24,20 +24,50 @@
 
 #include <cstdint>
 #include <cstring>
+#include <type_traits>
+#include <intern/details/eq.hpp>
 #include <intern/details/utils.hpp>
 
 namespace intern {
 
 struct default_string_traits
 {
+    // Length of interned strings: at most 65535 bytes. Longer strings
+    // given as std::string are refused (details::checked_size), lengths
+    // passed as a size_type already are the caller's to check.
     using size_type = std::uint16_t;
 
     constexpr static auto string_far_use_ptr_equality = true;
 
+    // Keep 32 bits of the interner hash in front of every interned string
+    // so that hash() does not need to look at the characters
+    constexpr static auto metadata_store_hash = false;
+
+    // Give every interned string a sequential 32 bit id, kept in front of
+    // it as well (see string_id)
+    constexpr static auto metadata_store_id = false;
+
+    // Keep lengths below 65535 in 2 bytes whatever size_type is; longer
+    // strings get a full size_type in front of their header. Lifts the
+    // 64 KiB limit (with a wider size_type) without growing every header.
+    constexpr static auto metadata_short_size = false;
+
+    // Keep the position of every string in byte order in front of it, so
+    // that comparing two strings of the same interner compares two
+    // integers (see details::rank_order). Strings of different interners
+    // still compare by their bytes. Not for concurrent interners.
+    constexpr static auto metadata_store_rank = false;
+
     inline static int cmp(const char* a, const char* b, std::size_t sz)
     {
         return std::memcmp(a, b, sz);
     }
+    // Same as !cmp(a, b, sz), used wherever only equality matters. Traits
+    // that override cmp but not eq get !cmp instead (details::traits_eq).
+    inline static bool eq(const char* a, const char* b, std::size_t sz)
+    {
+        return details::equal(a, b, sz);
+    }
     inline static void* copy(
             char* INTERN__RESTRICT dst,
             const char* INTERN__RESTRICT src,
@@ -48,5 +78,47 @@ struct default_string_traits
 
 };
 
+namespace details {
+
+template<typename Traits, typename = void>
+struct has_eq : std::false_type {};
+
+template<typename Traits>
+struct has_eq<Traits, std::void_t<decltype(&Traits::eq)>> : std::true_type {};
+
+// Whether equality has to go through !Traits::cmp: string traits with a
+// cmp of their own that have no eq, or only the one of
+// default_string_traits, would otherwise compare equal differently than
+// they order
+template<typename Traits>
+constexpr bool eq_from_cmp() noexcept
+{
+    if constexpr(!has_eq<Traits>::value)
+    {
+        return true;
+    }
+    else
+    {
+        return &Traits::cmp != &default_string_traits::cmp
+            && &Traits::eq == &default_string_traits::eq;
+    }
+}
+
+// Every equality check on interned strings
+template<typename Traits>
+inline bool traits_eq(const char* a, const char* b, std::size_t sz)
+{
+    if constexpr(eq_from_cmp<Traits>())
+    {
+        return !Traits::cmp(a, b, sz);
+    }
+    else
+    {
+        return Traits::eq(a, b, sz);
+    }
+}
+
+}
+
 }
 
@@ -0,0 +1,225 @@
+#pragma once
+
+// The MIT License (MIT)
+//
+// Copyright (c) 2019 jh0x
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <intern/details/group.hpp>
+#include <intern/details/hash.hpp>
+#include <intern/details/metadata.hpp>
+#include <intern/details/utils.hpp>
+#include <intern/string_far.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace intern {
+namespace details {
+
+// Interner index that only keeps a 32 bit arena offset per slot plus a
+// separate array of 7 bit tags (one byte per slot). The length and the
+// characters are read back from the arena through the metadata, so a slot
+// costs 5 bytes instead of a full lookup_metadata + string_far pair.
+//
+// Offsets are translated by the caller supplied `address` function. Only
+// the lower 32 bits of the interner hash are used, which lets a rehash
+// reuse the hash kept in the metadata (Traits::metadata_store_hash).
+template<typename Traits, typename HasherT>
+class compact_index
+{
+public:
+    using size_type = typename Traits::size_type;
+    using lookup_metadata = details::lookup_metadata<Traits>;
+    constexpr static auto npos = std::uint32_t(-1);
+
+    compact_index() { _reset(kMinCapacity); }
+
+    // Offset of the stored copy of lm or npos
+    template<typename Address>
+    std::uint32_t find(const lookup_metadata& lm, Address address) const noexcept
+    {
+        const auto h = _mix(lm._hash);
+        const auto tag = _tag(h);
+        for(auto pos = h & _mask; ; pos = (pos + kGroupSize) & _mask)
+        {
+            const group g{&_ctrl[pos]};
+            for(auto m = g.match(tag); m; m &= m - 1)
+            {
+                const auto i = (pos + __builtin_ctz(m)) & _mask;
+                const char* p = address(_slots[i]);
+                if(string_far<Traits>{p}.size() == lm._len
+                        && traits_eq<Traits>(p, lm._data, lm._len))
+                {
+                    return _slots[i];
+                }
+            }
+            if(INTERN__LIKELY(g.match_empty()))
+            {
+                return npos;
+            }
+        }
+    }
+
+    // Adds an offset that is known not to be present yet
+    template<typename Address>
+    void insert(std::size_t hash, std::uint32_t off, Address address)
+    {
+        if(INTERN__UNLIKELY((_size + 1) * 8 > _capacity() * 7))
+        {
+            _grow(address);
+        }
+        _place(_mix(hash), off);
+        ++_size;
+    }
+
+    void prefetch(const lookup_metadata& lm) const noexcept
+    {
+        const auto pos = _mix(lm._hash) & _mask;
+        __builtin_prefetch(&_ctrl[pos]);
+        __builtin_prefetch(&_slots[pos]);
+    }
+
+    template<typename F>
+    void for_each(F&& f) const
+    {
+        for(std::size_t i = 0; i != _capacity(); ++i)
+        {
+            if(_ctrl[i] != kEmpty)
+            {
+                f(_slots[i]);
+            }
+        }
+    }
+
+    // Number of stored offsets by the number of groups a lookup probes
+    // to find them: [0] one group, [1] two, ... Walks the whole index.
+    template<typename Address>
+    std::vector<std::size_t> probe_lengths(Address address) const
+    {
+        std::vector<std::size_t> res;
+        for(std::size_t i = 0; i != _capacity(); ++i)
+        {
+            if(_ctrl[i] == kEmpty)
+            {
+                continue;
+            }
+            const string_far<Traits> s{address(_slots[i])};
+            std::uint64_t h;
+            if constexpr(Traits::metadata_store_hash)
+            {
+                h = _mix(s.hash());
+            }
+            else
+            {
+                h = _mix(HasherT{}(s.data(), s.size()));
+            }
+            const auto groups = ((i - h) & _mask) / kGroupSize;
+            if(groups >= res.size())
+            {
+                res.resize(groups + 1);
+            }
+            ++res[groups];
+        }
+        return res;
+    }
+
+    std::size_t size() const noexcept { return _size; }
+    std::size_t capacity() const noexcept { return _capacity(); }
+    std::size_t bytes() const noexcept
+    {
+        return _ctrl.capacity() * sizeof(std::uint8_t)
+            + _slots.capacity() * sizeof(std::uint32_t);
+    }
+
+private:
+    constexpr static std::size_t kMinCapacity = 16;
+
+    static std::uint64_t _mix(std::size_t hash) noexcept
+    {
+        return mix64(static_cast<std::uint32_t>(hash));
+    }
+    static std::uint8_t _tag(std::uint64_t h) noexcept
+    {
+        return static_cast<std::uint8_t>(h >> 57);
+    }
+    std::size_t _capacity() const noexcept { return _slots.size(); }
+
+    void _reset(std::size_t capacity)
+    {
+        // The first group is mirrored past the end so that a group can be
+        // loaded at any position
+        _ctrl.assign(capacity + kGroupSize - 1, kEmpty);
+        _slots.assign(capacity, 0);
+        _mask = capacity - 1;
+        _size = 0;
+    }
+
+    void _place(std::uint64_t h, std::uint32_t off) noexcept
+    {
+        for(auto pos = h & _mask; ; pos = (pos + kGroupSize) & _mask)
+        {
+            if(const auto m = group{&_ctrl[pos]}.match_empty())
+            {
+                const auto i = (pos + __builtin_ctz(m)) & _mask;
+                _ctrl[i] = _tag(h);
+                if(i < kGroupSize - 1)
+                {
+                    _ctrl[_capacity() + i] = _tag(h);
+                }
+                _slots[i] = off;
+                return;
+            }
+        }
+    }
+
+    template<typename Address>
+    void _grow(Address address)
+    {
+        std::vector<std::uint32_t> old;
+        old.reserve(_size);
+        for_each([&old](std::uint32_t off) { old.push_back(off); });
+
+        const auto size = _size;
+        _reset(_capacity() * 2);
+        for(auto off : old)
+        {
+            const string_far<Traits> s{address(off)};
+            if constexpr(Traits::metadata_store_hash)
+            {
+                _place(_mix(s.hash()), off);
+            }
+            else
+            {
+                _place(_mix(HasherT{}(s.data(), s.size())), off);
+            }
+        }
+        _size = size;
+    }
+
+    std::vector<std::uint8_t> _ctrl;
+    std::vector<std::uint32_t> _slots;
+    std::size_t _mask = 0;
+    std::size_t _size = 0;
+};
+
+}
+}
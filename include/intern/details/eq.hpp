@@ -0,0 +1,154 @@
+#pragma once
+
+// The MIT License (MIT)
+//
+// Copyright (c) 2019 jh0x
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <intern/details/utils.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace intern {
+namespace details {
+
+// Equality of two byte ranges of the same length. Every length is covered
+// by (at most) two overlapping loads of the widest size that fits, so
+// nothing is read past the end and there is no byte loop; longer inputs
+// compare whole vectors and finish with one that ends at the last byte.
+
+inline bool eq_small(const char* a, const char* b, std::size_t n) noexcept
+{
+    if(n >= 8)
+    {
+        std::uint64_t a0, a1, b0, b1;
+        std::memcpy(&a0, a, 8);
+        std::memcpy(&b0, b, 8);
+        std::memcpy(&a1, a + n - 8, 8);
+        std::memcpy(&b1, b + n - 8, 8);
+        return ((a0 ^ b0) | (a1 ^ b1)) == 0;
+    }
+    if(n >= 4)
+    {
+        std::uint32_t a0, a1, b0, b1;
+        std::memcpy(&a0, a, 4);
+        std::memcpy(&b0, b, 4);
+        std::memcpy(&a1, a + n - 4, 4);
+        std::memcpy(&b1, b + n - 4, 4);
+        return ((a0 ^ b0) | (a1 ^ b1)) == 0;
+    }
+    if(n)
+    {
+        // 1 - 3 bytes: first, middle and last
+        const auto x = static_cast<unsigned>(a[0] ^ b[0])
+            | static_cast<unsigned>(a[n >> 1] ^ b[n >> 1])
+            | static_cast<unsigned>(a[n - 1] ^ b[n - 1]);
+        return (x & 0xFFU) == 0;
+    }
+    return true;
+}
+
+#if defined(__SSE2__)
+inline __m128i cmp16(const char* a, const char* b) noexcept
+{
+    return _mm_cmpeq_epi8(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(a)),
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(b)));
+}
+inline bool all16(__m128i m) noexcept
+{
+    return _mm_movemask_epi8(m) == 0xFFFF;
+}
+#endif
+#if defined(__AVX2__)
+inline __m256i cmp32(const char* a, const char* b) noexcept
+{
+    return _mm256_cmpeq_epi8(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a)),
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b)));
+}
+inline bool all32(__m256i m) noexcept
+{
+    return _mm256_movemask_epi8(m) == -1;
+}
+// 64 bytes from p, a single branch
+inline bool eq64(const char* a, const char* b) noexcept
+{
+    return all32(_mm256_and_si256(cmp32(a, b), cmp32(a + 32, b + 32)));
+}
+#elif defined(__SSE2__)
+inline bool eq64(const char* a, const char* b) noexcept
+{
+    return all16(_mm_and_si128(
+                _mm_and_si128(cmp16(a, b), cmp16(a + 16, b + 16)),
+                _mm_and_si128(cmp16(a + 32, b + 32), cmp16(a + 48, b + 48))));
+}
+#endif
+
+inline bool equal(const char* a, const char* b, std::size_t n) noexcept
+{
+#if defined(__SSE2__)
+    if(INTERN__LIKELY(n < 16))
+    {
+        return eq_small(a, b, n);
+    }
+    if(n <= 32)
+    {
+        return all16(_mm_and_si128(
+                    cmp16(a, b), cmp16(a + n - 16, b + n - 16)));
+    }
+    if(n <= 64)
+    {
+#if defined(__AVX2__)
+        return all32(_mm256_and_si256(
+                    cmp32(a, b), cmp32(a + n - 32, b + n - 32)));
+#else
+        return all16(_mm_and_si128(
+                    _mm_and_si128(cmp16(a, b), cmp16(a + 16, b + 16)),
+                    _mm_and_si128(cmp16(a + n - 32, b + n - 32),
+                        cmp16(a + n - 16, b + n - 16))));
+#endif
+    }
+    for(std::size_t i = 0; i + 64 < n; i += 64)
+    {
+        if(!eq64(a + i, b + i))
+        {
+            return false;
+        }
+    }
+    return eq64(a + n - 64, b + n - 64);
+#else
+    if(n <= 16)
+    {
+        return eq_small(a, b, n);
+    }
+    return std::memcmp(a, b, n) == 0;
+#endif
+}
+
+}
+}
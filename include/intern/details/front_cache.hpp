@@ -0,0 +1,183 @@
+#pragma once
+
+// The MIT License (MIT)
+//
+// Copyright (c) 2019 jh0x
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <intern/default_string_traits.hpp>
+#include <intern/details/utils.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace intern {
+namespace details {
+
+// Optional per thread cache in front of the interner (ITraits::front_cache
+// entries). It is 2-way set associative on the hash: new strings go to the
+// second way, and a hit there swaps the entry into the first one, so a
+// burst of one-off strings cannot push out the hot ones. An entry only
+// matches when the instance id, hash, length and characters all match, so
+// a hit never gives a wrong string. Ids are never reused, so entries left
+// by a destroyed interner simply never match again.
+
+struct front_cache_stats
+{
+    std::uint64_t hits;
+    std::uint64_t misses;
+};
+
+inline std::uint64_t next_instance_id() noexcept
+{
+    static std::atomic<std::uint64_t> id{0};
+    return id.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+// Id of an interner with a front cache, nothing otherwise
+template<bool Enabled>
+struct instance_id
+{
+    std::uint64_t _value = next_instance_id();
+};
+
+template<>
+struct instance_id<false> {};
+
+template<typename Traits, typename Tag, std::size_t N>
+class front_cache
+{
+public:
+    static_assert(N >= 2 && !(N & (N - 1)),
+            "the front cache size must be a power of two");
+    using size_type = typename Traits::size_type;
+
+    // The calling thread's cache, shared by every interner of type Tag
+    static front_cache& local() noexcept
+    {
+        static thread_local front_cache c;
+        return c;
+    }
+
+    const char* find(std::uint64_t owner, std::size_t hash,
+            const char* s, size_type sz) noexcept
+    {
+        auto* set = _entries + (hash & (kSets - 1)) * 2;
+        if(INTERN__LIKELY(set[0]._matches(owner, hash, s, sz)))
+        {
+            _bump(_hits);
+            return set[0]._data;
+        }
+        if(set[1]._matches(owner, hash, s, sz))
+        {
+            _bump(_hits);
+            std::swap(set[0], set[1]);
+            return set[0]._data;
+        }
+        _bump(_misses);
+        return nullptr;
+    }
+
+    void put(std::uint64_t owner, std::size_t hash,
+            const char* data, size_type sz) noexcept
+    {
+        _entries[(hash & (kSets - 1)) * 2 + 1] = entry{owner, hash, data, sz};
+    }
+
+    // Sum over every thread, past and present
+    static front_cache_stats stats()
+    {
+        auto& r = _registry();
+        std::lock_guard<std::mutex> lock{r._mutex};
+        auto res = r._retired;
+        for(const auto* c : r._live)
+        {
+            res.hits += c->_hits.load(std::memory_order_relaxed);
+            res.misses += c->_misses.load(std::memory_order_relaxed);
+        }
+        return res;
+    }
+
+private:
+    constexpr static std::size_t kSets = N / 2;
+
+    struct entry
+    {
+        bool _matches(std::uint64_t owner, std::size_t hash,
+                const char* s, size_type sz) const noexcept
+        {
+            return _owner == owner && _hash == hash && _len == sz
+                && traits_eq<Traits>(_data, s, sz);
+        }
+
+        std::uint64_t _owner;
+        std::size_t _hash;
+        const char* _data;
+        size_type _len;
+    };
+
+    struct registry
+    {
+        std::mutex _mutex;
+        std::vector<const front_cache*> _live;
+        front_cache_stats _retired{0, 0};
+    };
+    static registry& _registry()
+    {
+        static registry r;
+        return r;
+    }
+
+    front_cache()
+    {
+        auto& r = _registry();
+        std::lock_guard<std::mutex> lock{r._mutex};
+        r._live.push_back(this);
+    }
+    ~front_cache()
+    {
+        auto& r = _registry();
+        std::lock_guard<std::mutex> lock{r._mutex};
+        r._retired.hits += _hits.load(std::memory_order_relaxed);
+        r._retired.misses += _misses.load(std::memory_order_relaxed);
+        r._live.erase(std::find(r._live.begin(), r._live.end(), this));
+    }
+    front_cache(const front_cache&) = delete;
+    front_cache& operator=(const front_cache&) = delete;
+
+    // Only the owning thread writes: no need for a locked increment
+    static void _bump(std::atomic<std::uint64_t>& c) noexcept
+    {
+        c.store(c.load(std::memory_order_relaxed) + 1,
+                std::memory_order_relaxed);
+    }
+
+    entry _entries[N] = {};
+    std::atomic<std::uint64_t> _hits{0};
+    std::atomic<std::uint64_t> _misses{0};
+};
+
+}
+}
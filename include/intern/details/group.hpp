@@ -0,0 +1,86 @@
+#pragma once
+
+// The MIT License (MIT)
+//
+// Copyright (c) 2019 jh0x
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cstdint>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace intern {
+namespace details {
+
+// 16 control bytes of an open addressing table. A byte with the top bit
+// set is an empty slot, anything else is the 7 bit tag of a full one.
+constexpr std::uint8_t kEmpty = 0x80;
+constexpr std::size_t kGroupSize = 16;
+
+#if defined(__SSE2__)
+struct group
+{
+    explicit group(const std::uint8_t* p) noexcept
+        : _ctrl{_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))}
+    {}
+
+    std::uint32_t match(std::uint8_t tag) const noexcept
+    {
+        return static_cast<std::uint32_t>(_mm_movemask_epi8(
+                    _mm_cmpeq_epi8(_mm_set1_epi8(static_cast<char>(tag)), _ctrl)));
+    }
+    std::uint32_t match_empty() const noexcept
+    {
+        return static_cast<std::uint32_t>(_mm_movemask_epi8(_ctrl));
+    }
+
+    __m128i _ctrl;
+};
+#else
+struct group
+{
+    explicit group(const std::uint8_t* p) noexcept : _ctrl{p} {}
+
+    std::uint32_t match(std::uint8_t tag) const noexcept
+    {
+        std::uint32_t m = 0;
+        for(std::size_t i = 0; i != kGroupSize; ++i)
+        {
+            m |= std::uint32_t(_ctrl[i] == tag) << i;
+        }
+        return m;
+    }
+    std::uint32_t match_empty() const noexcept
+    {
+        std::uint32_t m = 0;
+        for(std::size_t i = 0; i != kGroupSize; ++i)
+        {
+            m |= std::uint32_t(_ctrl[i] >> 7) << i;
+        }
+        return m;
+    }
+
+    const std::uint8_t* _ctrl;
+};
+#endif
+
+}
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+// The MIT License (MIT)
+//
+// Copyright (c) 2019 jh0x
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace intern {
+namespace details {
+
+constexpr std::uint64_t mix64(std::uint64_t x) noexcept
+{
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return x;
+}
+
+// Maps x uniformly onto [0, n) without a division
+constexpr std::size_t fastrange(std::uint64_t x, std::size_t n) noexcept
+{
+    return static_cast<std::size_t>(
+            (static_cast<unsigned __int128>(x) * n) >> 64);
+}
+
+// Cheap hash for the few bytes kept inline by the small strings
+inline std::size_t hash_small(const char* p, std::size_t sz) noexcept
+{
+    std::uint64_t h = sz * 0x9e3779b97f4a7c15ULL;
+    for(; sz >= 8; sz -= 8, p += 8)
+    {
+        std::uint64_t w;
+        std::memcpy(&w, p, 8);
+        h = mix64(h ^ w);
+    }
+    std::uint64_t w = 0;
+    for(std::size_t i = 0; i != sz; ++i)
+    {
+        w |= std::uint64_t(static_cast<unsigned char>(p[i])) << (8 * i);
+    }
+    return mix64(h ^ w);
+}
+
+}
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+// The MIT License (MIT)
+//
+// Copyright (c) 2019 jh0x
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <intern/details/segments.hpp>
+#include <intern/details/utils.hpp>
+
+#include <atomic>
+#include <cstdint>
+
+namespace intern {
+namespace details {
+
+// Id -> string of an interner with Traits::metadata_store_id. Ids are
+// handed out in order and never reused; the table never moves, so lookups
+// stay valid while strings are added by other threads. An id is counted
+// before its string is complete: pointers are published with release so
+// that find() sees either null or the whole string.
+template<bool Enabled>
+class id_table
+{
+public:
+    // Next id, whose string is given to publish() once it is written
+    std::uint32_t next() noexcept
+    {
+        return _next.fetch_add(1, std::memory_order_relaxed);
+    }
+    void publish(std::uint32_t id, const char* p)
+    {
+        _strings.at(id).store(p, std::memory_order_release);
+    }
+    // Known id (strings of a mapped base); the next push() comes after it
+    void set(std::uint32_t id, const char* p)
+    {
+        _strings.at(id).store(p, std::memory_order_release);
+        auto next = _next.load(std::memory_order_relaxed);
+        while(next <= id && !_next.compare_exchange_weak(next, id + 1,
+                    std::memory_order_relaxed))
+        {}
+    }
+
+    const char* operator[](std::uint32_t id) const noexcept
+    {
+        return _strings[id].load(std::memory_order_acquire);
+    }
+    // String of any id, null for those not handed out (yet)
+    const char* find(std::uint32_t id) const noexcept
+    {
+        if(INTERN__LIKELY(id < size()))
+        {
+            if(const auto* p = _strings.find(id))
+            {
+                return p->load(std::memory_order_acquire);
+            }
+        }
+        return nullptr;
+    }
+    std::uint32_t size() const noexcept
+    {
+        return _next.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<std::uint32_t> _next{0};
+    segments<std::atomic<const char*>> _strings;
+};
+
+template<>
+class id_table<false> {};
+
+}
+}
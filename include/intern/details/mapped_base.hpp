@@ -0,0 +1,446 @@
+#pragma once
+
+// The MIT License (MIT)
+//
+// Copyright (c) 2019 jh0x
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <intern/details/metadata.hpp>
+#include <intern/details/phf.hpp>
+#include <intern/details/utils.hpp>
+#include <intern/string_far.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define INTERN__HAS_MMAP 1
+#endif
+
+namespace intern {
+namespace details {
+
+// On-disk image of an interner (see interner::save() / load()). Nothing in
+// it is a pointer: strings are stored with their metadata exactly as the
+// interner lays them out, and the index is a phf over 32 bit offsets into
+// that arena. Mapping the file is all it takes to use it again.
+//
+//   header | arena | pilots | slots | spilled     (sections 64 byte aligned)
+//
+// The file is in native byte order and only loads into an interner with
+// the same string traits and hasher (checked through the header).
+struct persist_header
+{
+    char _magic[8];
+    std::uint64_t _hasher_check;
+    std::uint32_t _metadata_size;
+    std::uint32_t _metadata_align;
+    std::uint32_t _size_type_size;
+    std::uint32_t _metadata_fields; // metadata_fields<Traits>()
+    std::uint64_t _count;
+    std::uint64_t _buckets;
+    std::uint64_t _dense;
+    std::uint64_t _table_size;
+    std::uint64_t _spilled;
+    std::uint64_t _arena_at;
+    std::uint64_t _arena_size;
+    std::uint64_t _pilots_at;
+    std::uint64_t _slots_at;
+    std::uint64_t _spilled_at;
+    std::uint64_t _file_size;
+};
+
+// Optional metadata fields: 1 = hash, 2 = id, 4 = short size, 8 = rank
+template<typename Traits>
+constexpr std::uint32_t metadata_fields() noexcept
+{
+    return (Traits::metadata_store_hash ? 1u : 0u)
+        | (Traits::metadata_store_id ? 2u : 0u)
+        | (Traits::metadata_short_size ? 4u : 0u)
+        | (Traits::metadata_store_rank ? 8u : 0u);
+}
+
+constexpr char kPersistMagic[8] = {'I', 'N', 'T', 'E', 'R', 'N', '0', '1'};
+
+// Hash of a fixed string: files written with another hasher are refused
+template<typename HasherT>
+std::uint64_t hasher_check() noexcept
+{
+    return static_cast<std::uint64_t>(
+            HasherT{}("intern::persist_header", 22));
+}
+
+// Read-only layer of strings from a file mapped by open(). Copies share
+// the mapping, which goes away with the last of them.
+template<typename Traits, typename HasherT>
+class mapped_base
+{
+public:
+    using size_type = typename Traits::size_type;
+    using stringF = string_far<Traits>;
+
+    bool empty() const noexcept { return !_map; }
+    std::size_t size() const noexcept { return _map ? _hdr->_count : 0; }
+
+    // Interned copy of s (hash being HasherT of it) or nullptr. Offsets
+    // are checked as they are used: strings of a corrupt file that would
+    // lie outside the arena are never found.
+    const char* find(std::size_t hash, const char* s, size_type sz)
+        const noexcept
+    {
+        const auto o = _slots[_phf.slot(hash)];
+        if(INTERN__LIKELY(o != kNone))
+        {
+            const char* p = _string(o);
+            if(INTERN__LIKELY(p && _match(p, s, sz)))
+            {
+                return p;
+            }
+        }
+        for(std::size_t k = 0; k != _hdr->_spilled; ++k)
+        {
+            const char* p = _string(_spilled[k]);
+            if(p && _match(p, s, sz))
+            {
+                return p;
+            }
+        }
+        return nullptr;
+    }
+
+    // f(data) for every string, skipping offsets outside the arena
+    template<typename F>
+    void for_each(F&& f) const
+    {
+        if(!_map)
+        {
+            return;
+        }
+        for(std::size_t k = 0; k != _hdr->_table_size; ++k)
+        {
+            if(_slots[k] != kNone)
+            {
+                if(const char* p = _string(_slots[k]))
+                {
+                    f(p);
+                }
+            }
+        }
+        for(std::size_t k = 0; k != _hdr->_spilled; ++k)
+        {
+            if(const char* p = _string(_spilled[k]))
+            {
+                f(p);
+            }
+        }
+    }
+
+    bool open(const char* path);
+
+    // Takes (HasherT hash, interned data) pairs
+    static bool write(const char* path,
+            const std::vector<std::pair<std::size_t, const char*>>& entries);
+
+private:
+    using metadata = details::metadata<Traits>;
+    constexpr static std::uint32_t kNone = std::uint32_t(-1);
+    constexpr static std::size_t kSection = 64;
+
+    struct mapping
+    {
+        mapping(void* a, std::size_t l, bool m) noexcept
+            : _addr{a}, _len{l}, _mapped{m}
+        {}
+        mapping(const mapping&) = delete;
+        mapping& operator=(const mapping&) = delete;
+        ~mapping()
+        {
+#ifdef INTERN__HAS_MMAP
+            if(_mapped)
+            {
+                ::munmap(_addr, _len);
+                return;
+            }
+#endif
+            std::free(_addr);
+        }
+        void* _addr;
+        std::size_t _len;
+        bool _mapped;
+    };
+
+    static bool _match(const char* p, const char* s, size_type sz) noexcept
+    {
+        return stringF{p}.size() == sz && traits_eq<Traits>(p, s, sz);
+    }
+    static std::size_t _align(std::size_t n, std::size_t a) noexcept
+    {
+        return (n + (a - 1)) & ~(a - 1);
+    }
+    // Whether n items of size bytes from at end by end
+    static bool _fits(std::uint64_t at, std::uint64_t n, std::size_t size,
+            std::uint64_t end) noexcept
+    {
+        return at <= end && n <= (end - at) / size;
+    }
+    static std::shared_ptr<mapping> _map_file(const char* path);
+    const char* _string(std::uint32_t o) const noexcept;
+    bool _attach(std::shared_ptr<mapping> m) noexcept;
+
+    std::shared_ptr<mapping> _map;
+    const persist_header* _hdr = nullptr;
+    const char* _arena = nullptr;
+    const std::uint32_t* _slots = nullptr;
+    const std::uint32_t* _spilled = nullptr;
+    phf_view _phf;
+};
+
+template<typename Traits, typename HasherT>
+bool mapped_base<Traits, HasherT>::write(const char* path,
+        const std::vector<std::pair<std::size_t, const char*>>& entries)
+{
+    const auto n = entries.size();
+    std::vector<std::size_t> hashes;
+    hashes.reserve(n);
+    for(const auto& e : entries)
+    {
+        hashes.push_back(e.first);
+    }
+    phf f;
+    const auto slot_of = f.build(hashes);
+
+    // Strings with their metadata, laid out as the interner does it
+    std::vector<char> arena;
+    std::vector<std::uint32_t> slots(f.table_size(), kNone);
+    std::vector<std::uint32_t> spilled;
+    for(std::size_t k = 0; k != n; ++k)
+    {
+        const char* d = entries[k].second;
+        const auto len = stringF{d}.size();
+        const auto header = details::header_bytes<Traits>(len);
+        const auto at = _align(arena.size(), alignof(metadata));
+        const auto bytes = header + len + 1;
+        if(at + bytes > kNone)
+        {
+            return false;
+        }
+        arena.resize(at + bytes, '\0');
+        std::memcpy(arena.data() + at, d - header, bytes);
+        const auto o = static_cast<std::uint32_t>(at + header);
+        if(INTERN__LIKELY(slot_of[k] != phf::npos))
+        {
+            slots[slot_of[k]] = o;
+        }
+        else
+        {
+            spilled.push_back(o);
+        }
+    }
+
+    const auto& pilots = f.pilots();
+    persist_header h{};
+    std::memcpy(h._magic, kPersistMagic, sizeof(h._magic));
+    h._hasher_check = hasher_check<HasherT>();
+    h._metadata_size = sizeof(metadata);
+    h._metadata_align = alignof(metadata);
+    h._size_type_size = sizeof(size_type);
+    h._metadata_fields = metadata_fields<Traits>();
+    h._count = n;
+    h._buckets = pilots.size();
+    h._dense = f.dense();
+    h._table_size = f.table_size();
+    h._spilled = spilled.size();
+    h._arena_at = _align(sizeof(h), kSection);
+    h._arena_size = arena.size();
+    h._pilots_at = _align(h._arena_at + arena.size(), kSection);
+    h._slots_at = _align(h._pilots_at
+            + pilots.size() * sizeof(phf::pilot_type), kSection);
+    h._spilled_at = _align(h._slots_at
+            + slots.size() * sizeof(std::uint32_t), kSection);
+    h._file_size = h._spilled_at + spilled.size() * sizeof(std::uint32_t);
+
+    // Written next to the target and renamed over it, so that a process
+    // mapping the old file never sees a partial one
+    const std::string tmp = std::string(path) + ".tmp";
+    std::FILE* out = std::fopen(tmp.c_str(), "wb");
+    if(!out)
+    {
+        return false;
+    }
+    std::size_t at = 0;
+    bool ok = true;
+    const auto put = [&](std::size_t where, const void* p, std::size_t len)
+    {
+        static const char zeros[kSection] = {};
+        ok = ok && std::fwrite(zeros, 1, where - at, out) == where - at;
+        ok = ok && (!len || std::fwrite(p, 1, len, out) == len);
+        at = where + len;
+    };
+    put(0, &h, sizeof(h));
+    put(h._arena_at, arena.data(), arena.size());
+    put(h._pilots_at, pilots.data(), pilots.size() * sizeof(phf::pilot_type));
+    put(h._slots_at, slots.data(), slots.size() * sizeof(std::uint32_t));
+    put(h._spilled_at, spilled.data(), spilled.size() * sizeof(std::uint32_t));
+    ok = (std::fclose(out) == 0) && ok;
+    ok = ok && std::rename(tmp.c_str(), path) == 0;
+    if(!ok)
+    {
+        std::remove(tmp.c_str());
+    }
+    return ok;
+}
+
+template<typename Traits, typename HasherT>
+auto mapped_base<Traits, HasherT>::_map_file(const char* path)
+    -> std::shared_ptr<mapping>
+{
+#ifdef INTERN__HAS_MMAP
+    const int fd = ::open(path, O_RDONLY);
+    if(fd < 0)
+    {
+        return nullptr;
+    }
+    struct stat st;
+    if(::fstat(fd, &st) != 0 || st.st_size < off_t(sizeof(persist_header)))
+    {
+        ::close(fd);
+        return nullptr;
+    }
+    const auto len = static_cast<std::size_t>(st.st_size);
+    void* p = ::mmap(nullptr, len, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if(p == MAP_FAILED)
+    {
+        return nullptr;
+    }
+#ifdef MADV_WILLNEED
+    // Start reading ahead without waiting for it
+    ::madvise(p, len, MADV_WILLNEED);
+#endif
+    return std::make_shared<mapping>(p, len, true);
+#else
+    std::FILE* in = std::fopen(path, "rb");
+    if(!in)
+    {
+        return nullptr;
+    }
+    std::fseek(in, 0, SEEK_END);
+    const auto len = static_cast<std::size_t>(std::ftell(in));
+    std::fseek(in, 0, SEEK_SET);
+    void* p = std::malloc(len ? len : 1);
+    const bool ok = p && std::fread(p, 1, len, in) == len;
+    std::fclose(in);
+    if(!ok)
+    {
+        std::free(p);
+        return nullptr;
+    }
+    return std::make_shared<mapping>(p, len, false);
+#endif
+}
+
+// The string at offset o of the arena, or nullptr unless it lies within
+// the arena with its header and terminator
+template<typename Traits, typename HasherT>
+const char* mapped_base<Traits, HasherT>::_string(std::uint32_t o)
+    const noexcept
+{
+    const auto size = _hdr->_arena_size;
+    if(INTERN__UNLIKELY(o < sizeof(metadata) || o >= size))
+    {
+        return nullptr;
+    }
+    // The stored length tells whether a full size_type comes first
+    const char* p = _arena + o;
+    const auto stored = metadata_of<Traits>(p)._len;
+    if(INTERN__UNLIKELY(
+            o < header_bytes<Traits>(static_cast<size_type>(stored))
+            || o + std::uint64_t(stringF{p}.size()) >= size))
+    {
+        return nullptr;
+    }
+    return p;
+}
+
+template<typename Traits, typename HasherT>
+bool mapped_base<Traits, HasherT>::_attach(std::shared_ptr<mapping> m) noexcept
+{
+    const auto* base = static_cast<const char*>(m->_addr);
+    const auto* h = reinterpret_cast<const persist_header*>(base);
+    const bool ok = m->_len >= sizeof(*h)
+        && !std::memcmp(h->_magic, kPersistMagic, sizeof(h->_magic))
+        && h->_hasher_check == hasher_check<HasherT>()
+        && h->_metadata_size == sizeof(metadata)
+        && h->_metadata_align == alignof(metadata)
+        && h->_size_type_size == sizeof(size_type)
+        && h->_metadata_fields == metadata_fields<Traits>()
+        && h->_file_size == m->_len
+        && h->_buckets > h->_dense && h->_table_size > 0
+        && h->_count >= h->_spilled
+        && h->_count - h->_spilled <= h->_table_size
+        // Sections in order, aligned and within the file. Only the header
+        // is read here: the offsets are checked where they are used, so
+        // that a warm start does not page in the whole file.
+        && (h->_arena_at | h->_pilots_at | h->_slots_at | h->_spilled_at)
+            % kSection == 0
+        && h->_arena_at >= sizeof(*h)
+        && _fits(h->_arena_at, h->_arena_size, 1, h->_pilots_at)
+        && _fits(h->_pilots_at, h->_buckets, sizeof(phf::pilot_type),
+            h->_slots_at)
+        && _fits(h->_slots_at, h->_table_size, sizeof(std::uint32_t),
+            h->_spilled_at)
+        && _fits(h->_spilled_at, h->_spilled, sizeof(std::uint32_t),
+            h->_file_size);
+    if(!ok)
+    {
+        return false;
+    }
+    _hdr = h;
+    _arena = base + h->_arena_at;
+    _slots = reinterpret_cast<const std::uint32_t*>(base + h->_slots_at);
+    _spilled = reinterpret_cast<const std::uint32_t*>(base + h->_spilled_at);
+    _phf = phf_view{
+        reinterpret_cast<const phf::pilot_type*>(base + h->_pilots_at),
+        static_cast<std::size_t>(h->_buckets),
+        static_cast<std::size_t>(h->_dense),
+        static_cast<std::size_t>(h->_table_size)};
+    _map = std::move(m);
+    return true;
+}
+
+template<typename Traits, typename HasherT>
+bool mapped_base<Traits, HasherT>::open(const char* path)
+{
+    auto m = _map_file(path);
+    return m && _attach(std::move(m));
+}
+
+}
+}
@@ -22,23 +22,181 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#include <intern/default_string_traits.hpp>
+#include <intern/details/utils.hpp>
+
 #include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <stdexcept>
 
 namespace intern {
 namespace details {
 
+// How the length is kept in the metadata: as a plain Traits::size_type, or
+// (Traits::metadata_short_size) as 2 bytes for anything shorter than
+// kLong, the full length going to a size_type in front of the whole header
+// only for longer strings.
+template<typename Traits, bool = Traits::metadata_short_size>
+struct size_header
+{
+    using size_type = typename Traits::size_type;
+    using stored_type = size_type;
+
+    constexpr static std::size_t prefix(size_type) noexcept { return 0; }
+    constexpr static stored_type stored(size_type l) noexcept { return l; }
+    static void write_prefix(char*, size_type) noexcept {}
+    template<typename M>
+    constexpr static size_type read(const M& m) noexcept { return m._len; }
+};
+
+template<typename Traits>
+struct size_header<Traits, true>
+{
+    using size_type = typename Traits::size_type;
+    using stored_type = std::uint16_t;
+    static_assert(sizeof(size_type) > sizeof(stored_type),
+            "short sizes only pay off with a wider size_type");
+    constexpr static stored_type kLong = 0xFFFF;
+
+    constexpr static std::size_t prefix(size_type l) noexcept
+    {
+        return l < kLong ? 0 : sizeof(size_type);
+    }
+    constexpr static stored_type stored(size_type l) noexcept
+    {
+        return l < kLong ? static_cast<stored_type>(l) : kLong;
+    }
+    static void write_prefix(char* at, size_type l) noexcept
+    {
+        if(l >= kLong)
+        {
+            std::memcpy(at, &l, sizeof(l));
+        }
+    }
+    template<typename M>
+    static size_type read(const M& m) noexcept
+    {
+        if(INTERN__LIKELY(m._len != kLong))
+        {
+            return m._len;
+        }
+        size_type l;
+        std::memcpy(&l, reinterpret_cast<const char*>(&m) - sizeof(l),
+                sizeof(l));
+        return l;
+    }
+};
+
+// n as a Traits::size_type, for lengths that did not come as one: longer
+// strings cannot be interned and are refused rather than truncated
+template<typename Traits>
+typename Traits::size_type checked_size(std::size_t n)
+{
+    using size_type = typename Traits::size_type;
+    if(INTERN__UNLIKELY(n > std::numeric_limits<size_type>::max()))
+    {
+#ifdef __cpp_exceptions
+        throw std::length_error("intern: string longer than size_type");
+#else
+        std::abort();
+#endif
+    }
+    return static_cast<size_type>(n);
+}
+
+// Optional fields of the metadata, in this order in front of the length.
+// Only the enabled ones take any room.
+
+// Order of the string among all others (Traits::metadata_store_rank): 0 for
+// strings that are not ranked. Ranks of different interners are unrelated,
+// _space tells them apart (0 for strings that are not ranked either).
+constexpr std::uint64_t kNoRank = 0;
+
+template<bool>
+struct [[gnu::packed]] metadata_rank
+{
+    std::uint64_t _rank = kNoRank;
+    std::uint32_t _space = 0;
+};
+template<>
+struct metadata_rank<false> {};
+
+// (The lower half of) the hash computed by the interner
+template<bool>
+struct [[gnu::packed]] metadata_hash
+{
+    using hash_type = std::uint32_t;
+    constexpr explicit metadata_hash(std::size_t h)
+        : _hash{static_cast<hash_type>(h)}
+    {}
+    hash_type _hash;
+};
+template<>
+struct metadata_hash<false>
+{
+    constexpr explicit metadata_hash(std::size_t) {}
+};
+
+// Id given by the interner (Traits::metadata_store_id, see string_id);
+// strings that never got one (e.g. those of a scoped_interner) keep kNoId
+constexpr std::uint32_t kNoId = std::uint32_t(-1);
+
+template<bool>
+struct [[gnu::packed]] metadata_id
+{
+    std::uint32_t _id = kNoId;
+};
+template<>
+struct metadata_id<false> {};
+
 template<typename Traits>
 struct [[gnu::packed]] metadata
+    : metadata_rank<Traits::metadata_store_rank>
+    , metadata_hash<Traits::metadata_store_hash>
+    , metadata_id<Traits::metadata_store_id>
 {
     using size_type = typename Traits::size_type;
-    constexpr metadata(size_type l) : _len{l} {}
+    using header = size_header<Traits>;
+    constexpr metadata(size_type l, std::size_t h = 0)
+        : metadata_hash<Traits::metadata_store_hash>{h}
+        , _len{header::stored(l)}
+    {}
     metadata(const metadata&) = delete;
     metadata& operator=(const metadata&) = delete;
 
-    size_type _len;
+    typename header::stored_type _len;
     alignas(2) char _data[0];
 };
 
+// Metadata of an interned string
+template<typename Traits>
+inline metadata<Traits>& metadata_of(const char* data) noexcept
+{
+    return *reinterpret_cast<metadata<Traits>*>(
+            const_cast<char*>(data) - sizeof(metadata<Traits>));
+}
+
+// Bytes in front of the characters of a string of length l
+template<typename Traits>
+constexpr std::size_t header_bytes(typename Traits::size_type l) noexcept
+{
+    return size_header<Traits>::prefix(l) + sizeof(metadata<Traits>);
+}
+
+// Lays out the header of a string of length l from mem on (header_bytes(l)
+// bytes); the characters go to the _data of the result
+template<typename Traits>
+metadata<Traits>* make_metadata(
+        void* mem, typename Traits::size_type l, std::size_t hash) noexcept
+{
+    auto* at = static_cast<char*>(mem);
+    size_header<Traits>::write_prefix(at, l);
+    return new(at + size_header<Traits>::prefix(l)) metadata<Traits>{l, hash};
+}
 
 template<typename Traits>
 struct lookup_metadata
@@ -55,7 +213,7 @@ struct lookup_metadata
     constexpr bool operator==(const lookup_metadata& o) const noexcept
     {
         return ( (_hash == o._hash) & (_len == o._len) )
-            && !Traits::cmp(_data, o._data, _len);
+            && traits_eq<Traits>(_data, o._data, _len);
     }
 
     friend constexpr std::size_t hash_value(const lookup_metadata& m) noexcept
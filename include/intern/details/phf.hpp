@@ -0,0 +1,209 @@
+#pragma once
+
+// The MIT License (MIT)
+//
+// Copyright (c) 2019 jh0x
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <intern/details/hash.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+namespace intern {
+namespace details {
+
+// Perfect hash over a fixed set of (already computed) hashes in the
+// spirit of PTHash: keys are spread over skewed buckets and every bucket
+// is given the smallest "pilot" that moves all of its keys to free slots.
+// A lookup is one read of the small pilot table plus one slot access.
+class phf
+{
+public:
+    using pilot_type = std::uint16_t;
+    constexpr static auto npos = std::size_t(-1);
+
+    // Returns the slot assigned to every hash. Buckets for which no pilot
+    // works (only happens when hashes collide completely) are left out and
+    // their keys get npos.
+    std::vector<std::size_t> build(const std::vector<std::size_t>& hashes);
+
+    std::size_t slot(std::size_t h) const noexcept
+    {
+        return _position(h, _pilots[_bucket(h)]);
+    }
+
+    std::size_t table_size() const noexcept { return _table_size; }
+    std::size_t bytes() const noexcept
+    {
+        return _pilots.size() * sizeof(pilot_type);
+    }
+
+    // Raw state, for storing the function elsewhere (see phf_view)
+    const std::vector<pilot_type>& pilots() const noexcept { return _pilots; }
+    std::size_t dense() const noexcept { return _dense; }
+
+    static std::size_t bucket(std::size_t h,
+            std::size_t dense, std::size_t buckets) noexcept
+    {
+        const auto y = mix64(h + 0x9e3779b97f4a7c15ULL);
+        return h < kDenseKeys
+            ? fastrange(y, dense)
+            : dense + fastrange(y, buckets - dense);
+    }
+    static std::size_t position(std::size_t h, pilot_type p,
+            std::size_t table_size) noexcept
+    {
+        return fastrange(mix64(h) ^ mix64(p + 0x2545f4914f6cdd1dULL),
+                table_size);
+    }
+
+private:
+    // 60% of the keys land in 30% of the buckets: the big buckets are
+    // placed first while the table is still empty.
+    constexpr static std::uint64_t kDenseKeys = 0x9999999999999999ULL;
+
+    std::size_t _bucket(std::size_t h) const noexcept
+    {
+        return bucket(h, _dense, _pilots.size());
+    }
+    std::size_t _position(std::size_t h, pilot_type p) const noexcept
+    {
+        return position(h, p, _table_size);
+    }
+
+    std::vector<pilot_type> _pilots = std::vector<pilot_type>(2);
+    std::size_t _dense = 1;
+    std::size_t _table_size = 1;
+};
+
+// A phf whose pilots live in memory owned by someone else (a mapped file)
+class phf_view
+{
+public:
+    using pilot_type = phf::pilot_type;
+
+    phf_view() = default;
+    phf_view(const pilot_type* pilots, std::size_t buckets,
+            std::size_t dense, std::size_t table_size) noexcept
+        : _pilots{pilots}
+        , _buckets{buckets}
+        , _dense{dense}
+        , _table_size{table_size}
+    {}
+
+    std::size_t slot(std::size_t h) const noexcept
+    {
+        return phf::position(h, _pilots[phf::bucket(h, _dense, _buckets)],
+                _table_size);
+    }
+    std::size_t table_size() const noexcept { return _table_size; }
+
+private:
+    const pilot_type* _pilots = nullptr;
+    std::size_t _buckets = 0;
+    std::size_t _dense = 0;
+    std::size_t _table_size = 0;
+};
+
+inline std::vector<std::size_t> phf::build(
+        const std::vector<std::size_t>& hashes)
+{
+    const auto n = hashes.size();
+    const auto buckets = std::max<std::size_t>(2, (n + 4) / 5);
+    _pilots.assign(buckets, 0);
+    _dense = std::min(std::max<std::size_t>(1, buckets * 3 / 10), buckets - 1);
+    _table_size = std::max<std::size_t>(1, n + n / 32);
+
+    // Group the keys by bucket
+    std::vector<std::size_t> start(buckets + 1, 0);
+    std::vector<std::size_t> bucket_of(n);
+    for(std::size_t k = 0; k != n; ++k)
+    {
+        bucket_of[k] = _bucket(hashes[k]);
+        ++start[bucket_of[k] + 1];
+    }
+    std::partial_sum(start.begin(), start.end(), start.begin());
+    std::vector<std::size_t> keys(n);
+    {
+        auto fill = start;
+        for(std::size_t k = 0; k != n; ++k)
+        {
+            keys[fill[bucket_of[k]]++] = k;
+        }
+    }
+
+    // Biggest buckets first
+    std::vector<std::size_t> order(buckets);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+            [&start](std::size_t a, std::size_t b)
+            {
+                return start[a + 1] - start[a] > start[b + 1] - start[b];
+            });
+
+    std::vector<std::size_t> result(n, npos);
+    std::vector<bool> taken(_table_size, false);
+    std::vector<std::size_t> pos;
+    for(auto b : order)
+    {
+        const auto first = start[b];
+        const auto last = start[b + 1];
+        if(first == last)
+        {
+            break;
+        }
+        std::size_t p = 0;
+        for(; p <= pilot_type(-1); ++p)
+        {
+            pos.clear();
+            for(auto k = first; k != last; ++k)
+            {
+                const auto q = _position(hashes[keys[k]], pilot_type(p));
+                if(taken[q] || std::find(pos.begin(), pos.end(), q) != pos.end())
+                {
+                    break;
+                }
+                pos.push_back(q);
+            }
+            if(pos.size() == last - first)
+            {
+                break;
+            }
+        }
+        if(p > pilot_type(-1))
+        {
+            continue;
+        }
+        _pilots[b] = pilot_type(p);
+        for(auto k = first; k != last; ++k)
+        {
+            taken[pos[k - first]] = true;
+            result[keys[k]] = pos[k - first];
+        }
+    }
+    return result;
+}
+
+}
+}
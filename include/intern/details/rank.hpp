@@ -0,0 +1,162 @@
+#pragma once
+
+// The MIT License (MIT)
+//
+// Copyright (c) 2019 jh0x
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <intern/details/metadata.hpp>
+#include <intern/string_far.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <set>
+
+namespace intern {
+namespace details {
+
+// Tags the ranks of one interner; never 0, which marks unranked strings.
+// Unique until 2^32 ranked interners have been created.
+inline std::uint32_t next_rank_space() noexcept
+{
+    static std::atomic<std::uint32_t> space{0};
+    const auto res = space.fetch_add(1, std::memory_order_relaxed) + 1;
+    return res ? res : next_rank_space();
+}
+
+// Ranks of the strings of an ordered interner (Traits::metadata_store_rank):
+// 64 bit numbers in the metadata that sort like the strings do, valid
+// between strings of the same rank space (one per interner). A new
+// string takes a number between those of its neighbours. When there is
+// none left, the smallest window around it that is sparse enough is
+// spread out evenly again. Windows grow by doubling up to the whole set,
+// which keeps the relabeling amortized to a few strings per insertion.
+template<typename Traits, bool Enabled>
+class rank_order
+{
+public:
+    void insert(const char* data)
+    {
+        const auto it = _order.insert(data).first;
+        const auto lo = it == _order.begin() ? kNoRank : _rank(*std::prev(it));
+        const auto next = std::next(it);
+        const auto hi = next == _order.end() ? kEnd : _rank(*next);
+        if(INTERN__LIKELY(hi - lo >= 2))
+        {
+            // The first string goes in the middle; the others leave room
+            // at the ends for many more in (reverse) order
+            std::uint64_t step = (hi - lo) / 2;
+            if((next == _order.end()) != (lo == kNoRank))
+            {
+                step = std::min(step, kGap);
+            }
+            _set(data, next == _order.end() ? lo + step : hi - step);
+            return;
+        }
+        _relabel(it);
+    }
+    void erase(const char* data) { _order.erase(data); }
+
+    // Strings given new ranks so far
+    std::size_t relabeled() const noexcept { return _relabeled; }
+
+private:
+    using stringF = string_far<Traits>;
+    constexpr static std::uint64_t kEnd = std::uint64_t(-1);
+    constexpr static std::uint64_t kGap = std::uint64_t(1) << 32;
+
+    struct less
+    {
+        bool operator()(const char* a, const char* b) const noexcept
+        {
+            return stringF{a}.compare(stringF{b}) < 0;
+        }
+    };
+    using iterator = typename std::set<const char*, less>::iterator;
+
+    static std::uint64_t _rank(const char* data) noexcept
+    {
+        return metadata_of<Traits>(data)._rank;
+    }
+    // The rank space only goes in with the first rank: until then the
+    // string compares by its bytes
+    void _set(const char* data, std::uint64_t r) noexcept
+    {
+        auto& m = metadata_of<Traits>(data);
+        m._rank = r;
+        m._space = _space;
+    }
+
+    void _relabel(iterator at)
+    {
+        // [first, last] around the new string, doubling until the ranks
+        // between the neighbours of the window leave each string more
+        // room than the window holds strings
+        auto first = at;
+        auto last = at;
+        std::size_t count = 1;
+        for(std::size_t want = 2;; want *= 2)
+        {
+            while(count < want && (first != _order.begin()
+                        || std::next(last) != _order.end()))
+            {
+                if(first != _order.begin())
+                {
+                    --first;
+                    ++count;
+                }
+                if(count < want && std::next(last) != _order.end())
+                {
+                    ++last;
+                    ++count;
+                }
+            }
+            const auto lo = first == _order.begin()
+                ? kNoRank : _rank(*std::prev(first));
+            const auto after = std::next(last);
+            const auto hi = after == _order.end() ? kEnd : _rank(*after);
+            const bool whole = count == _order.size();
+            if((hi - lo) / (count + 1) > count || whole)
+            {
+                const auto step = (hi - lo) / (count + 1);
+                auto r = lo;
+                for(auto it = first; it != after; ++it)
+                {
+                    r += step;
+                    _set(*it, r);
+                }
+                _relabeled += count;
+                return;
+            }
+        }
+    }
+
+    std::set<const char*, less> _order;
+    std::size_t _relabeled = 0;
+    std::uint32_t _space = next_rank_space();
+};
+
+template<typename Traits>
+class rank_order<Traits, false> {};
+
+}
+}
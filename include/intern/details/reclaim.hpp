@@ -0,0 +1,119 @@
+#pragma once
+
+// The MIT License (MIT)
+//
+// Copyright (c) 2019 jh0x
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+namespace intern {
+namespace details {
+
+// Support for reclaiming interners (ITraits::reclaim). Every string gets a
+// 32 bit reference count in front of its metadata:
+//
+//   [refcount][metadata][data...\0]
+//
+// string_ref handles count references. A string that was ever handed out
+// as a plain string_far is pinned (top bit) and never freed, because
+// string_far copies are not tracked.
+struct refcount
+{
+    using type = std::uint32_t;
+    constexpr static type kPinned = type(1) << 31;
+    constexpr static std::size_t kBlockAlign = 16;
+};
+
+// Blocks of freed strings, one intrusive list per size class: multiples of
+// 16 bytes up to 4KB, powers of two above that
+class free_lists
+{
+public:
+    constexpr static std::size_t kSmall = 4096;
+
+    static std::size_t block_size(std::size_t bytes) noexcept
+    {
+        if(bytes <= kSmall)
+        {
+            return (bytes + 15) & ~std::size_t(15);
+        }
+        std::size_t b = kSmall;
+        while(b < bytes)
+        {
+            b <<= 1;
+        }
+        return b;
+    }
+
+    void* pop(std::size_t block) noexcept
+    {
+        auto& head = _heads[_class(block)];
+        node* n = head;
+        if(n)
+        {
+            head = n->_next;
+            _bytes -= block;
+        }
+        return n;
+    }
+    void push(void* p, std::size_t block) noexcept
+    {
+        auto& head = _heads[_class(block)];
+        head = new(p) node{head};
+        _bytes += block;
+    }
+
+    // Bytes waiting in the lists to be reused
+    std::size_t bytes() const noexcept { return _bytes; }
+
+private:
+    struct node
+    {
+        node* _next;
+    };
+
+    static std::size_t _class(std::size_t block) noexcept
+    {
+        if(block <= kSmall)
+        {
+            return block / 16;
+        }
+        return kSmall / 16 + 64 - __builtin_clzll(block) - 12;
+    }
+
+    node* _heads[kSmall / 16 + 64] = {};
+    std::size_t _bytes = 0;
+};
+
+// State of a reclaiming interner, nothing otherwise
+template<bool Enabled>
+struct reclaim_state
+{
+    free_lists _free;
+};
+
+template<>
+struct reclaim_state<false> {};
+
+}
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+// The MIT License (MIT)
+//
+// Copyright (c) 2019 jh0x
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace intern {
+namespace details {
+
+// Array indexed by 32 bit values that grows in segments doubling in size
+// (segment k starts at index kFirst * (2^k - 1)). Segments never move:
+// references stay valid while other threads add segments, and reaching an
+// element is one bit scan. Elements start value-initialized.
+template<typename T>
+class segments
+{
+public:
+    segments() = default;
+    segments(const segments&) = delete;
+    segments& operator=(const segments&) = delete;
+    ~segments()
+    {
+        for(auto& s : _segments)
+        {
+            delete[] s.load(std::memory_order_relaxed);
+        }
+    }
+
+    // Element i, that must have been reached through at() before
+    const T& operator[](std::uint32_t i) const noexcept
+    {
+        const auto k = _segment_of(i);
+        return _segments[k].load(std::memory_order_acquire)[i - _base(k)];
+    }
+    // Element i, or null while its segment has not been added
+    const T* find(std::uint32_t i) const noexcept
+    {
+        const auto k = _segment_of(i);
+        const T* seg = _segments[k].load(std::memory_order_acquire);
+        return seg ? seg + (i - _base(k)) : nullptr;
+    }
+    // Element i, adding its segment if needed
+    T& at(std::uint32_t i)
+    {
+        const auto k = _segment_of(i);
+        auto* seg = _segments[k].load(std::memory_order_acquire);
+        if(!seg)
+        {
+            // First one in there: racing threads keep a single segment
+            auto* fresh = new T[kFirst << k]();
+            if(_segments[k].compare_exchange_strong(seg, fresh,
+                        std::memory_order_acq_rel))
+            {
+                seg = fresh;
+            }
+            else
+            {
+                delete[] fresh;
+            }
+        }
+        return seg[i - _base(k)];
+    }
+
+private:
+    constexpr static std::size_t kShift = 10;
+    constexpr static std::size_t kFirst = std::size_t(1) << kShift;
+    // kFirst * (2^kSegments - 1) >= 2^32
+    constexpr static std::size_t kSegments = 33 - kShift;
+
+    static std::size_t _base(std::size_t k) noexcept
+    {
+        return ((std::size_t(1) << k) - 1) << kShift;
+    }
+    static std::size_t _segment_of(std::size_t i) noexcept
+    {
+        return 63 - __builtin_clzll((i >> kShift) + 1);
+    }
+
+    std::atomic<T*> _segments[kSegments] = {};
+};
+
+}
+}
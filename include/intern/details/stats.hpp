@@ -0,0 +1,216 @@
+#pragma once
+
+// The MIT License (MIT)
+//
+// Copyright (c) 2019 jh0x
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+namespace intern {
+namespace details {
+
+// Optional counters of an interner (ITraits::statistics). They cost one
+// relaxed increment per lookup plus a few per new string, and nothing at
+// all when the knob is off.
+//
+// Reading never blocks far(). Each counter block has a single writer
+// which bumps it without a locked instruction; concurrent interners keep
+// one cache line aligned block per thread stripe instead (a thread always
+// uses the same one) and sum them on read.
+
+// Strings by length: [0] empty, [k] from 2^(k-1) to 2^k - 1, the last
+// bucket takes everything longer
+constexpr std::size_t kLengthBuckets = 17;
+
+inline std::size_t length_bucket(std::size_t len) noexcept
+{
+    if(len == 0)
+    {
+        return 0;
+    }
+    const auto k = static_cast<std::size_t>(64 - __builtin_clzll(len));
+    return k < kLengthBuckets ? k : kLengthBuckets - 1;
+}
+
+struct interner_stats
+{
+    // Strings looked up by far() and friends, front cache hits included
+    std::uint64_t lookups;
+    // ... that were interned already
+    std::uint64_t hits;
+    // ... that had to be stored, and their characters
+    std::uint64_t misses;
+    std::uint64_t string_bytes;
+    // New strings by length (see length_bucket)
+    std::array<std::uint64_t, kLengthBuckets> lengths;
+
+    // size(), index_bytes() and the fill ratio of the lookup structure (0
+    // when it does not tell its capacity)
+    std::size_t distinct;
+    std::size_t index_bytes;
+    double load_factor;
+    // Bytes handed out and mapped by the allocator, when it tells (arena)
+    std::size_t arena_used;
+    std::size_t arena_reserved;
+
+    double hit_ratio() const noexcept
+    {
+        return lookups ? double(hits) / double(lookups) : 0.0;
+    }
+};
+
+// One line of name=value pairs, for logs and metrics exporters
+inline std::ostream& operator<<(std::ostream& o, const interner_stats& s)
+{
+    o << "lookups=" << s.lookups
+      << " hits=" << s.hits
+      << " misses=" << s.misses
+      << " hit_ratio=" << s.hit_ratio()
+      << " distinct=" << s.distinct
+      << " string_bytes=" << s.string_bytes
+      << " index_bytes=" << s.index_bytes
+      << " load_factor=" << s.load_factor
+      << " arena_used=" << s.arena_used
+      << " arena_reserved=" << s.arena_reserved
+      << " lengths=";
+    for(std::size_t k = 0; k != kLengthBuckets; ++k)
+    {
+        o << (k ? "," : "") << s.lengths[k];
+    }
+    return o;
+}
+
+template<bool Shared>
+class stat_block
+{
+public:
+    void lookup() noexcept { _bump(_lookups, 1); }
+    void store(std::size_t len) noexcept
+    {
+        _bump(_misses, 1);
+        _bump(_bytes, len);
+        _bump(_lengths[length_bucket(len)], 1);
+    }
+
+    void add_to(interner_stats& s) const noexcept
+    {
+        s.lookups += _lookups.load(std::memory_order_relaxed);
+        s.misses += _misses.load(std::memory_order_relaxed);
+        s.string_bytes += _bytes.load(std::memory_order_relaxed);
+        for(std::size_t k = 0; k != kLengthBuckets; ++k)
+        {
+            s.lengths[k] += _lengths[k].load(std::memory_order_relaxed);
+        }
+    }
+
+private:
+    static void _bump(std::atomic<std::uint64_t>& c, std::uint64_t n) noexcept
+    {
+        if constexpr(Shared)
+        {
+            c.fetch_add(n, std::memory_order_relaxed);
+        }
+        else
+        {
+            c.store(c.load(std::memory_order_relaxed) + n,
+                    std::memory_order_relaxed);
+        }
+    }
+
+    std::atomic<std::uint64_t> _lookups{0};
+    std::atomic<std::uint64_t> _misses{0};
+    std::atomic<std::uint64_t> _bytes{0};
+    std::atomic<std::uint64_t> _lengths[kLengthBuckets] = {};
+};
+
+template<bool Enabled, bool Concurrent>
+class stats_state
+{
+public:
+    void lookup() noexcept {}
+    void store(std::size_t) noexcept {}
+};
+
+template<>
+class stats_state<true, false>
+{
+public:
+    void lookup() noexcept { _block.lookup(); }
+    void store(std::size_t len) noexcept { _block.store(len); }
+    interner_stats read() const noexcept
+    {
+        interner_stats s{};
+        _block.add_to(s);
+        s.hits = s.lookups - s.misses;
+        return s;
+    }
+
+private:
+    stat_block<false> _block;
+};
+
+template<>
+class stats_state<true, true>
+{
+public:
+    constexpr static std::size_t kStripes = 16;
+
+    void lookup() noexcept { _stripes[_stripe()]._block.lookup(); }
+    void store(std::size_t len) noexcept
+    {
+        _stripes[_stripe()]._block.store(len);
+    }
+    interner_stats read() const noexcept
+    {
+        interner_stats s{};
+        for(const auto& st : _stripes)
+        {
+            st._block.add_to(s);
+        }
+        // The stripes are read one after the other while others count
+        s.hits = s.lookups > s.misses ? s.lookups - s.misses : 0;
+        return s;
+    }
+
+private:
+    struct alignas(64) stripe
+    {
+        stat_block<true> _block;
+    };
+
+    // Threads take the stripes in turn, the first time they count
+    static std::size_t _stripe() noexcept
+    {
+        static std::atomic<std::size_t> next{0};
+        static thread_local const std::size_t mine =
+            next.fetch_add(1, std::memory_order_relaxed) % kStripes;
+        return mine;
+    }
+
+    stripe _stripes[kStripes];
+};
+
+}
+}
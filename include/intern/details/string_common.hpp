@@ -22,6 +22,8 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#include <intern/details/metadata.hpp>
+
 #include <iterator>
 
 namespace intern {
@@ -95,6 +97,20 @@ public:
     template<typename U>
     int compare(const string_common<U, Traits>& o) const noexcept
     {
+        if constexpr(Traits::metadata_store_rank)
+        {
+            // Both ranked by the same interner: ranks sort like bytes
+            if(!static_cast<const T*>(this)->small()
+                    && !static_cast<const U&>(o).small())
+            {
+                const auto& a = metadata_of<Traits>(data());
+                const auto& b = metadata_of<Traits>(o.data());
+                if(INTERN__LIKELY((a._space == b._space) & (a._space != 0)))
+                {
+                    return a._rank == b._rank ? 0 : a._rank < b._rank ? -1 : 1;
+                }
+            }
+        }
         if(auto result = Traits::cmp(data(), o.data(),
                     std::min(size(), o.size())))
         {
@@ -111,7 +127,8 @@ bool operator==(
         const details::string_common<T, Traits>& a,
         const char (&b)[N]) noexcept
 {
-    return a.size() == (N - 1) && !Traits::cmp(a.data(), b, N - 1);
+    return a.size() == (N - 1)
+        && details::traits_eq<Traits>(a.data(), b, N - 1);
 }
 template<size_t N, typename T, typename Traits>
 bool operator!=(
@@ -126,7 +143,8 @@ bool operator==(
         const details::string_common<T, Traits>& a,
         const details::string_common<U, Traits>& b) noexcept
 {
-    return a.size() == b.size() && !Traits::cmp(a.data(), b.data(), a.size());
+    return a.size() == b.size()
+        && details::traits_eq<Traits>(a.data(), b.data(), a.size());
 }
 template<typename T, typename U, typename Traits>
 bool operator!=(
@@ -0,0 +1,181 @@
+#pragma once
+
+// The MIT License (MIT)
+//
+// Copyright (c) 2019 jh0x
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+namespace intern {
+namespace details {
+
+// Optional interner traits (ITraits) knobs. An ITraits that does not
+// mention a knob gets the default behaviour.
+
+template<typename ITraits, typename = void>
+struct is_concurrent : std::false_type {};
+
+template<typename ITraits>
+struct is_concurrent<ITraits, std::void_t<decltype(ITraits::concurrent)>>
+    : std::integral_constant<bool, ITraits::concurrent> {};
+
+template<typename ITraits, typename = void>
+struct is_compact : std::false_type {};
+
+template<typename ITraits>
+struct is_compact<ITraits, std::void_t<decltype(ITraits::compact_index)>>
+    : std::integral_constant<bool, ITraits::compact_index> {};
+
+template<typename ITraits, typename = void>
+struct is_reclaiming : std::false_type {};
+
+template<typename ITraits>
+struct is_reclaiming<ITraits, std::void_t<decltype(ITraits::reclaim)>>
+    : std::integral_constant<bool, ITraits::reclaim> {};
+
+template<typename ITraits, typename = void>
+struct front_cache_size : std::integral_constant<std::size_t, 0> {};
+
+template<typename ITraits>
+struct front_cache_size<ITraits, std::void_t<decltype(ITraits::front_cache)>>
+    : std::integral_constant<std::size_t, ITraits::front_cache> {};
+
+// Hit, miss and length counters (ITraits::statistics, see stats_state)
+
+template<typename ITraits, typename = void>
+struct has_statistics : std::false_type {};
+
+template<typename ITraits>
+struct has_statistics<ITraits, std::void_t<decltype(ITraits::statistics)>>
+    : std::integral_constant<bool, ITraits::statistics> {};
+
+// Allocators may tell how many bytes they handed out (used()) and mapped
+// (reserved()), like arena
+
+template<typename A, typename = void>
+struct has_usage : std::false_type {};
+
+template<typename A>
+struct has_usage<A, std::void_t<decltype(std::declval<const A&>().used()),
+        decltype(std::declval<const A&>().reserved())>>
+    : std::true_type {};
+
+// Per instance allocator (ITraits::allocatorT) instead of the static
+// ITraits::allocate / offset / address
+
+template<typename ITraits, typename = void>
+struct has_allocator : std::false_type {};
+
+template<typename ITraits>
+struct has_allocator<ITraits, std::void_t<typename ITraits::allocatorT>>
+    : std::true_type {};
+
+// The static ITraits functions behind the interface of an allocatorT
+template<typename ITraits>
+struct static_allocator
+{
+    static void* allocate(std::size_t s, std::size_t a)
+        noexcept(noexcept(ITraits::allocate(s, a)))
+    {
+        return ITraits::allocate(s, a);
+    }
+    static std::uint32_t offset(const char* p) noexcept
+    {
+        return ITraits::offset(p);
+    }
+    static const char* address(std::uint32_t o) noexcept
+    {
+        return ITraits::address(o);
+    }
+};
+
+template<typename ITraits, bool = has_allocator<ITraits>::value>
+struct allocator_of
+{
+    using type = static_allocator<ITraits>;
+};
+
+template<typename ITraits>
+struct allocator_of<ITraits, true>
+{
+    using type = typename ITraits::allocatorT;
+};
+
+// Hashers may offer a constexpr static hash(s, l) with the same results,
+// used for literals (see literal)
+
+template<typename H, typename = void>
+struct has_static_hash : std::false_type {};
+
+template<typename H>
+struct has_static_hash<H, std::void_t<decltype(
+        H::hash(std::declval<const char*>(), std::size_t{}))>>
+    : std::true_type {};
+
+// Lookup structures (ITraits::lookupT) may offer prefetch(key)
+
+template<typename L, typename K, typename = void>
+struct has_prefetch : std::false_type {};
+
+template<typename L, typename K>
+struct has_prefetch<L, K, std::void_t<decltype(
+        std::declval<const L&>().prefetch(std::declval<const K&>()))>>
+    : std::true_type {};
+
+// Memory held by a lookup structure: asked directly when it knows
+// (bytes()), estimated from the capacity of phmap-like tables otherwise.
+template<typename L, typename = void>
+struct has_bytes : std::false_type {};
+
+template<typename L>
+struct has_bytes<L, std::void_t<decltype(std::declval<const L&>().bytes())>>
+    : std::true_type {};
+
+template<typename L, typename = void>
+struct has_capacity : std::false_type {};
+
+template<typename L>
+struct has_capacity<L, std::void_t<decltype(std::declval<const L&>().capacity())>>
+    : std::true_type {};
+
+template<typename L>
+std::size_t lookup_bytes(const L& l) noexcept
+{
+    if constexpr(has_bytes<L>::value)
+    {
+        return l.bytes();
+    }
+    else if constexpr(has_capacity<L>::value)
+    {
+        // One control byte per slot
+        return l.capacity() * (sizeof(typename L::value_type) + 1);
+    }
+    else
+    {
+        return l.size() * sizeof(typename L::value_type);
+    }
+}
+
+}
+}
@@ -0,0 +1,450 @@
+#pragma once
+
+// The MIT License (MIT)
+//
+// Copyright (c) 2019 jh0x
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <intern/details/group.hpp>
+#include <intern/details/hash.hpp>
+#include <intern/details/utils.hpp>
+#include <intern/string_sso_tiny.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace intern {
+namespace details {
+
+// How flat_map hashes and compares interned strings: far values by their
+// pointer, small ones by their few inline bytes. Never looks at the
+// characters of a far string, so keys must all come from one interner
+// (and its scoped interners).
+template<typename StringT>
+struct interned_key
+{
+    static std::uint64_t hash(const StringT& k) noexcept
+    {
+        if constexpr(StringT::sso_size != 0)
+        {
+            if(k.small())
+            {
+                return hash_small(k.data(), k.size());
+            }
+        }
+        return mix64(reinterpret_cast<std::uintptr_t>(k.data()));
+    }
+    static bool equal(const StringT& a, const StringT& b) noexcept
+    {
+        if constexpr(StringT::sso_size != 0)
+        {
+            if(a.small() | b.small())
+            {
+                return a.size() == b.size()
+                    && std::memcmp(a.data(), b.data(), a.size()) == 0;
+            }
+        }
+        return a.data() == b.data();
+    }
+};
+
+// The whole word of a tiny string identifies it either way
+template<typename Traits>
+struct interned_key<string_sso_tiny<Traits>>
+{
+    using StringT = string_sso_tiny<Traits>;
+    static std::uint64_t hash(const StringT& k) noexcept
+    {
+        return mix64(k._uint);
+    }
+    static bool equal(const StringT& a, const StringT& b) noexcept
+    {
+        return a._uint == b._uint;
+    }
+};
+
+}
+
+// Hash map keyed by interned strings (string_far or any small string type).
+// Keys are hashed and compared as integers (see details::interned_key),
+// never by their characters. Open addressing with 16 byte groups of 7 bit
+// tags like the compact index, keys and values stored inline. A default
+// constructed (or moved from) map has no table until the first insert.
+template<typename StringT, typename V>
+class flat_map
+{
+    template<bool Const> class iter;
+
+public:
+    using key_type = StringT;
+    using mapped_type = V;
+    using value_type = std::pair<const StringT, V>;
+    using size_type = std::size_t;
+    using iterator = iter<false>;
+    using const_iterator = iter<true>;
+
+    flat_map() noexcept = default;
+    flat_map(const flat_map& o)
+    {
+        reserve(o.size());
+        for(const auto& kv : o)
+        {
+            try_emplace(kv.first, kv.second);
+        }
+    }
+    flat_map(flat_map&& o) noexcept { swap(o); }
+    flat_map& operator=(flat_map o) noexcept
+    {
+        swap(o);
+        return *this;
+    }
+    ~flat_map()
+    {
+        _destroy();
+        if(_slots)
+        {
+            _alloc().deallocate(_slots, _capacity);
+        }
+    }
+
+    void swap(flat_map& o) noexcept
+    {
+        using std::swap;
+        swap(_ctrl, o._ctrl);
+        swap(_slots, o._slots);
+        swap(_capacity, o._capacity);
+        swap(_size, o._size);
+        swap(_used, o._used);
+    }
+
+    iterator begin() noexcept { return {this, _skip(0)}; }
+    iterator end() noexcept { return {this, _capacity}; }
+    const_iterator begin() const noexcept { return {this, _skip(0)}; }
+    const_iterator end() const noexcept { return {this, _capacity}; }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+
+    size_type size() const noexcept { return _size; }
+    bool empty() const noexcept { return _size == 0; }
+
+    iterator find(const StringT& k) noexcept
+    {
+        return {this, _find(k, key::hash(k))};
+    }
+    const_iterator find(const StringT& k) const noexcept
+    {
+        return {this, _find(k, key::hash(k))};
+    }
+    bool contains(const StringT& k) const noexcept
+    {
+        return find(k) != end();
+    }
+    size_type count(const StringT& k) const noexcept { return contains(k); }
+
+    V& at(const StringT& k)
+    {
+        const auto it = find(k);
+        if(it == end())
+        {
+#ifdef __cpp_exceptions
+            throw std::out_of_range("intern::flat_map::at");
+#else
+            std::abort();
+#endif
+        }
+        return it->second;
+    }
+    const V& at(const StringT& k) const
+    {
+        return const_cast<flat_map*>(this)->at(k);
+    }
+    V& operator[](const StringT& k) { return try_emplace(k).first->second; }
+
+    template<typename... Args>
+    std::pair<iterator, bool> try_emplace(const StringT& k, Args&&... args)
+    {
+        const auto h = key::hash(k);
+        const auto i = _find(k, h);
+        if(i != _capacity)
+        {
+            return {{this, i}, false};
+        }
+        if(INTERN__UNLIKELY((_used + 1) * 8 > _capacity * 7))
+        {
+            _rehash(_size * 2 >= _capacity
+                    ? std::max(_capacity * 2, kMinCapacity) : _capacity);
+        }
+        // The slot only counts as full once the value is there
+        const auto j = _free(h);
+        ::new(static_cast<void*>(_slots + j)) value_type(
+                std::piecewise_construct,
+                std::forward_as_tuple(k),
+                std::forward_as_tuple(std::forward<Args>(args)...));
+        _fill(j, h);
+        return {{this, j}, true};
+    }
+    std::pair<iterator, bool> insert(const value_type& kv)
+    {
+        return try_emplace(kv.first, kv.second);
+    }
+
+    size_type erase(const StringT& k) noexcept
+    {
+        const auto i = _find(k, key::hash(k));
+        if(i == _capacity)
+        {
+            return 0;
+        }
+        _slots[i].~value_type();
+        _set_ctrl(i, kDeleted);
+        --_size;
+        return 1;
+    }
+
+    void clear() noexcept
+    {
+        _destroy();
+        std::fill(_ctrl.begin(), _ctrl.end(), details::kEmpty);
+        _size = 0;
+        _used = 0;
+    }
+    void reserve(size_type n)
+    {
+        auto capacity = std::max(_capacity, kMinCapacity);
+        while(n * 8 > capacity * 7)
+        {
+            capacity *= 2;
+        }
+        if(capacity != _capacity && n != 0)
+        {
+            _rehash(capacity);
+        }
+    }
+
+    void prefetch(const StringT& k) const noexcept
+    {
+        if(INTERN__UNLIKELY(!_capacity))
+        {
+            return;
+        }
+        const auto pos = key::hash(k) & (_capacity - 1);
+        __builtin_prefetch(&_ctrl[pos]);
+        __builtin_prefetch(&_slots[pos]);
+    }
+    // Memory held by the table
+    std::size_t bytes() const noexcept
+    {
+        return _ctrl.capacity() + _capacity * sizeof(value_type);
+    }
+
+private:
+    using key = details::interned_key<StringT>;
+    constexpr static std::size_t kMinCapacity = 16;
+    // Top bit set like details::kEmpty, so that inserts reuse it, but only
+    // an empty slot ends a probe
+    constexpr static std::uint8_t kDeleted = 0xFE;
+
+    static std::uint8_t _tag(std::uint64_t h) noexcept
+    {
+        return static_cast<std::uint8_t>(h >> 57);
+    }
+    static std::allocator<value_type> _alloc() noexcept { return {}; }
+
+    std::size_t _find(const StringT& k, std::uint64_t h) const noexcept
+    {
+        if(INTERN__UNLIKELY(!_capacity))
+        {
+            return _capacity;
+        }
+        const auto mask = _capacity - 1;
+        const auto tag = _tag(h);
+        for(auto pos = h & mask; ; pos = (pos + details::kGroupSize) & mask)
+        {
+            const details::group g{&_ctrl[pos]};
+            for(auto m = g.match(tag); m; m &= m - 1)
+            {
+                const auto i = (pos + __builtin_ctz(m)) & mask;
+                if(INTERN__LIKELY(key::equal(_slots[i].first, k)))
+                {
+                    return i;
+                }
+            }
+            if(INTERN__LIKELY(g.match(details::kEmpty)))
+            {
+                return _capacity;
+            }
+        }
+    }
+
+    // Slot for a key known not to be there, still marked free
+    std::size_t _free(std::uint64_t h) const noexcept
+    {
+        const auto mask = _capacity - 1;
+        for(auto pos = h & mask; ; pos = (pos + details::kGroupSize) & mask)
+        {
+            if(const auto m = details::group{&_ctrl[pos]}.match_empty())
+            {
+                return (pos + __builtin_ctz(m)) & mask;
+            }
+        }
+    }
+    // Slot i of _free(h) now holds a value
+    void _fill(std::size_t i, std::uint64_t h) noexcept
+    {
+        _used += _ctrl[i] == details::kEmpty;
+        _set_ctrl(i, _tag(h));
+        ++_size;
+    }
+
+    void _set_ctrl(std::size_t i, std::uint8_t c) noexcept
+    {
+        // The first group is mirrored past the end
+        _ctrl[i] = c;
+        if(i < details::kGroupSize - 1)
+        {
+            _ctrl[_capacity + i] = c;
+        }
+    }
+
+    void _reset(std::size_t capacity)
+    {
+        _ctrl.assign(capacity + details::kGroupSize - 1, details::kEmpty);
+        _slots = _alloc().allocate(capacity);
+        _capacity = capacity;
+        _size = 0;
+        _used = 0;
+    }
+
+    void _rehash(std::size_t capacity)
+    {
+        auto ctrl = std::move(_ctrl);
+        auto* slots = _slots;
+        const auto old = _capacity;
+        _reset(capacity);
+        for(std::size_t i = 0; i != old; ++i)
+        {
+            if(!(ctrl[i] & 0x80))
+            {
+                auto& kv = slots[i];
+                const auto h = key::hash(kv.first);
+                const auto j = _free(h);
+                ::new(static_cast<void*>(_slots + j))
+                    value_type(kv.first, std::move(kv.second));
+                _fill(j, h);
+                kv.~value_type();
+            }
+        }
+        if(slots)
+        {
+            _alloc().deallocate(slots, old);
+        }
+    }
+
+    void _destroy() noexcept
+    {
+        if constexpr(!std::is_trivially_destructible<value_type>::value)
+        {
+            for(std::size_t i = 0; i != _capacity; ++i)
+            {
+                if(!(_ctrl[i] & 0x80))
+                {
+                    _slots[i].~value_type();
+                }
+            }
+        }
+    }
+
+    std::size_t _skip(std::size_t i) const noexcept
+    {
+        while(i != _capacity && (_ctrl[i] & 0x80))
+        {
+            ++i;
+        }
+        return i;
+    }
+
+    template<bool Const>
+    class iter
+    {
+        using map_ptr = std::conditional_t<Const, const flat_map*, flat_map*>;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = typename flat_map::value_type;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::conditional_t<Const,
+              const value_type&, value_type&>;
+        using pointer = std::conditional_t<Const,
+              const value_type*, value_type*>;
+
+        iter() = default;
+        iter(map_ptr m, std::size_t i) noexcept : _map{m}, _i{i} {}
+        // iterator -> const_iterator
+        template<bool C, typename = std::enable_if_t<Const && !C>>
+        iter(const iter<C>& o) noexcept : _map{o._map}, _i{o._i} {}
+
+        reference operator*() const noexcept { return _map->_slots[_i]; }
+        pointer operator->() const noexcept { return &_map->_slots[_i]; }
+        iter& operator++() noexcept
+        {
+            _i = _map->_skip(_i + 1);
+            return *this;
+        }
+        iter operator++(int) noexcept
+        {
+            auto tmp = *this;
+            ++*this;
+            return tmp;
+        }
+        friend bool operator==(const iter& a, const iter& b) noexcept
+        {
+            return a._i == b._i;
+        }
+        friend bool operator!=(const iter& a, const iter& b) noexcept
+        {
+            return a._i != b._i;
+        }
+
+    private:
+        template<bool> friend class iter;
+        map_ptr _map = nullptr;
+        std::size_t _i = 0;
+    };
+
+    std::vector<std::uint8_t> _ctrl;
+    value_type* _slots = nullptr;
+    std::size_t _capacity = 0;
+    std::size_t _size = 0;
+    // Slots that are not empty (full or deleted)
+    std::size_t _used = 0;
+};
+
+}
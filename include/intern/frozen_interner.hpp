@@ -0,0 +1,139 @@
+#pragma once
+
+// The MIT License (MIT)
+//
+// Copyright (c) 2019 jh0x
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <intern/details/phf.hpp>
+#include <intern/details/utils.hpp>
+#include <intern/string_far.hpp>
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace intern
+{
+
+// Immutable snapshot of an interner (see interner::freeze()). Lookups go
+// through a perfect hash so they touch the pilot table, one slot and the
+// string itself. Nothing is ever modified after construction, so find()
+// is safe to call from any number of threads without locking.
+template<typename Traits, typename HasherT>
+class frozen_interner
+{
+public:
+    using StringTraits = Traits;
+    using hasherT = HasherT;
+    using stringF = string_far<Traits>;
+    using size_type = typename Traits::size_type;
+
+    frozen_interner() : _slots(1, nullptr) {}
+
+    std::optional<stringF> find(const char* s, size_type sz) const noexcept;
+    std::optional<stringF> find(const std::string& s) const noexcept
+    {
+        return find(s.data(), s.size());
+    }
+    template<size_t N>
+    std::optional<stringF> find(const char (&s)[N]) const noexcept
+    {
+        return find(s, N - 1);
+    }
+
+    // Number of strings in the snapshot
+    std::size_t size() const noexcept { return _size; }
+
+    // Memory used by the index (not counting the strings themselves)
+    std::size_t index_bytes() const noexcept
+    {
+        return _phf.bytes()
+            + (_slots.capacity() + _spilled.capacity()) * sizeof(const char*);
+    }
+
+private:
+    template<typename, typename> friend class interner;
+
+    // Takes (hash, interned data) pairs
+    explicit frozen_interner(
+            const std::vector<std::pair<std::size_t, const char*>>& entries);
+
+    static bool _match(const char* p, const char* s, size_type sz) noexcept
+    {
+        return stringF{p}.size() == sz
+            && details::traits_eq<Traits>(p, s, sz);
+    }
+
+    details::phf _phf;
+    std::vector<const char*> _slots;
+    std::vector<const char*> _spilled;
+    std::size_t _size = 0;
+};
+
+template<typename Traits, typename HasherT>
+frozen_interner<Traits, HasherT>::frozen_interner(
+        const std::vector<std::pair<std::size_t, const char*>>& entries)
+    : _size{entries.size()}
+{
+    std::vector<std::size_t> hashes;
+    hashes.reserve(entries.size());
+    for(const auto& e : entries)
+    {
+        hashes.push_back(e.first);
+    }
+    const auto slots = _phf.build(hashes);
+
+    _slots.assign(_phf.table_size(), nullptr);
+    for(std::size_t k = 0; k != entries.size(); ++k)
+    {
+        if(INTERN__LIKELY(slots[k] != details::phf::npos))
+        {
+            _slots[slots[k]] = entries[k].second;
+        }
+        else
+        {
+            _spilled.push_back(entries[k].second);
+        }
+    }
+}
+
+template<typename Traits, typename HasherT>
+std::optional<string_far<Traits>> frozen_interner<Traits, HasherT>::find(
+        const char* s, size_type sz) const noexcept
+{
+    const char* p = _slots[_phf.slot(hasherT{}(s, sz))];
+    if(INTERN__LIKELY(p && _match(p, s, sz)))
+    {
+        return stringF{p};
+    }
+    for(const char* q : _spilled)
+    {
+        if(_match(q, s, sz))
+        {
+            return stringF{q};
+        }
+    }
+    return std::nullopt;
+}
+
+}
@@ -0,0 +1,409 @@
+#pragma once
+
+// The MIT License (MIT)
+//
+// Copyright (c) 2019 jh0x
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <intern/details/utils.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Bundled string hash in the XXH3 family. Inputs up to 16 bytes (the
+// common case for symbols) are read with two overlapping loads, up to 128
+// bytes as pairs of 16 byte blocks and anything longer goes through an
+// 8 lane accumulator that has SSE2 and AVX2 versions. The vector versions
+// compute exactly what the scalar code does, so hashes are the same
+// whatever the build flags.
+
+namespace intern {
+namespace details {
+namespace fh {
+
+constexpr std::uint64_t kPrime32_1 = 0x9E3779B1U;
+constexpr std::uint64_t kPrime32_2 = 0x85EBCA77U;
+constexpr std::uint64_t kPrime32_3 = 0xC2B2AE3DU;
+constexpr std::uint64_t kPrime64_1 = 0x9E3779B185EBCA87ULL;
+constexpr std::uint64_t kPrime64_2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr std::uint64_t kPrime64_3 = 0x165667B19E3779F9ULL;
+constexpr std::uint64_t kPrime64_4 = 0x85EBCA77C2B2AE63ULL;
+constexpr std::uint64_t kPrime64_5 = 0x27D4EB2F165667C5ULL;
+
+constexpr std::size_t kSecretSize = 192;
+constexpr std::size_t kStripe = 64;
+constexpr std::size_t kStripesPerBlock = (kSecretSize - kStripe) / 8;
+constexpr std::size_t kBlock = kStripe * kStripesPerBlock;
+
+struct secret_t
+{
+    unsigned char _b[kSecretSize];
+};
+
+// splitmix64 output as the key material
+constexpr secret_t make_secret() noexcept
+{
+    secret_t s{};
+    std::uint64_t x = 0x6a09e667f3bcc908ULL;
+    for(std::size_t i = 0; i != kSecretSize; i += 8)
+    {
+        x += 0x9e3779b97f4a7c15ULL;
+        std::uint64_t z = x;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        z ^= z >> 31;
+        for(std::size_t b = 0; b != 8; ++b)
+        {
+            s._b[i + b] = static_cast<unsigned char>(z >> (8 * b));
+        }
+    }
+    return s;
+}
+
+alignas(64) constexpr secret_t kSecret = make_secret();
+
+// Little endian loads written so that they stay usable in constant
+// expressions; compilers turn them into plain loads.
+template<typename C>
+constexpr std::uint64_t read64(const C* p) noexcept
+{
+    std::uint64_t v = 0;
+    for(std::size_t i = 0; i != 8; ++i)
+    {
+        v |= std::uint64_t(static_cast<unsigned char>(p[i])) << (8 * i);
+    }
+    return v;
+}
+template<typename C>
+constexpr std::uint64_t read32(const C* p) noexcept
+{
+    std::uint64_t v = 0;
+    for(std::size_t i = 0; i != 4; ++i)
+    {
+        v |= std::uint64_t(static_cast<unsigned char>(p[i])) << (8 * i);
+    }
+    return v;
+}
+
+constexpr std::uint64_t rotl(std::uint64_t x, unsigned r) noexcept
+{
+    return (x << r) | (x >> (64 - r));
+}
+constexpr std::uint64_t bswap(std::uint64_t x) noexcept
+{
+    return __builtin_bswap64(x);
+}
+constexpr std::uint64_t mum(std::uint64_t a, std::uint64_t b) noexcept
+{
+    const auto r = static_cast<unsigned __int128>(a) * b;
+    return static_cast<std::uint64_t>(r) ^ static_cast<std::uint64_t>(r >> 64);
+}
+constexpr std::uint64_t avalanche(std::uint64_t h) noexcept
+{
+    h ^= h >> 37;
+    h *= 0x165667919E3779F9ULL;
+    h ^= h >> 32;
+    return h;
+}
+constexpr std::uint64_t fmix(std::uint64_t h) noexcept
+{
+    h ^= h >> 33;
+    h *= kPrime64_2;
+    h ^= h >> 29;
+    h *= kPrime64_3;
+    h ^= h >> 32;
+    return h;
+}
+constexpr std::uint64_t rrmxmx(std::uint64_t h, std::uint64_t len) noexcept
+{
+    h ^= rotl(h, 49) ^ rotl(h, 24);
+    h *= 0x9FB21C651E98DF25ULL;
+    h ^= (h >> 35) + len;
+    h *= 0x9FB21C651E98DF25ULL;
+    h ^= h >> 28;
+    return h;
+}
+
+///////////////////////////////////////////////////////////////////////
+// 0 - 128 bytes
+
+template<typename C>
+constexpr std::uint64_t hash_0to16(const C* p, std::size_t len) noexcept
+{
+    const auto* s = kSecret._b;
+    if(len > 8)
+    {
+        const auto lo = read64(p) ^ (read64(s + 24) ^ read64(s + 32));
+        const auto hi = read64(p + len - 8) ^ (read64(s + 40) ^ read64(s + 48));
+        return avalanche(len + bswap(lo) + hi + mum(lo, hi));
+    }
+    if(len >= 4)
+    {
+        const auto x = read32(p + len - 4) + (read32(p) << 32);
+        return rrmxmx(x ^ (read64(s + 8) ^ read64(s + 16)), len);
+    }
+    if(len)
+    {
+        const auto c1 = static_cast<unsigned char>(p[0]);
+        const auto c2 = static_cast<unsigned char>(p[len >> 1]);
+        const auto c3 = static_cast<unsigned char>(p[len - 1]);
+        const std::uint64_t combined = (std::uint64_t(c1) << 16)
+            | (std::uint64_t(c2) << 24) | c3 | (std::uint64_t(len) << 8);
+        return fmix(combined ^ (read32(s) ^ read32(s + 4)));
+    }
+    return fmix(read64(s + 56) ^ read64(s + 64));
+}
+
+template<typename C>
+constexpr std::uint64_t mix16(const C* p, const unsigned char* s) noexcept
+{
+    return mum(read64(p) ^ read64(s), read64(p + 8) ^ read64(s + 8));
+}
+
+template<typename C>
+constexpr std::uint64_t hash_17to128(const C* p, std::size_t len) noexcept
+{
+    const auto* s = kSecret._b;
+    std::uint64_t acc = len * kPrime64_1;
+    if(len > 32)
+    {
+        if(len > 64)
+        {
+            if(len > 96)
+            {
+                acc += mix16(p + 48, s + 96);
+                acc += mix16(p + len - 64, s + 112);
+            }
+            acc += mix16(p + 32, s + 64);
+            acc += mix16(p + len - 48, s + 80);
+        }
+        acc += mix16(p + 16, s + 32);
+        acc += mix16(p + len - 32, s + 48);
+    }
+    acc += mix16(p, s);
+    acc += mix16(p + len - 16, s + 16);
+    return avalanche(acc);
+}
+
+///////////////////////////////////////////////////////////////////////
+// Long inputs: 8 lanes of 64 bit accumulators fed 64 bytes at a time
+
+struct acc_t
+{
+    std::uint64_t _a[8];
+};
+
+template<typename C>
+constexpr void accumulate_scalar(
+        acc_t& acc, const C* p, const unsigned char* key) noexcept
+{
+    for(std::size_t i = 0; i != 8; ++i)
+    {
+        const auto data = read64(p + 8 * i);
+        const auto dk = data ^ read64(key + 8 * i);
+        acc._a[i ^ 1] += data;
+        acc._a[i] += (dk & 0xFFFFFFFFU) * (dk >> 32);
+    }
+}
+
+constexpr void scramble_scalar(acc_t& acc, const unsigned char* key) noexcept
+{
+    for(std::size_t i = 0; i != 8; ++i)
+    {
+        auto a = acc._a[i];
+        a ^= a >> 47;
+        a ^= read64(key + 8 * i);
+        acc._a[i] = a * kPrime32_1;
+    }
+}
+
+#if defined(__AVX2__)
+inline void accumulate_simd(
+        acc_t& acc, const char* p, const unsigned char* key) noexcept
+{
+    auto* a = reinterpret_cast<__m256i*>(acc._a);
+    for(std::size_t i = 0; i != 2; ++i)
+    {
+        const auto data = _mm256_loadu_si256(
+                reinterpret_cast<const __m256i*>(p) + i);
+        const auto k = _mm256_loadu_si256(
+                reinterpret_cast<const __m256i*>(key) + i);
+        const auto dk = _mm256_xor_si256(data, k);
+        const auto dk_hi = _mm256_shuffle_epi32(dk, _MM_SHUFFLE(0, 3, 0, 1));
+        const auto product = _mm256_mul_epu32(dk, dk_hi);
+        const auto swapped = _mm256_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+        const auto sum = _mm256_add_epi64(_mm256_loadu_si256(a + i), swapped);
+        _mm256_storeu_si256(a + i, _mm256_add_epi64(product, sum));
+    }
+}
+inline void scramble_simd(acc_t& acc, const unsigned char* key) noexcept
+{
+    auto* a = reinterpret_cast<__m256i*>(acc._a);
+    const auto prime = _mm256_set1_epi32(static_cast<int>(kPrime32_1));
+    for(std::size_t i = 0; i != 2; ++i)
+    {
+        auto v = _mm256_loadu_si256(a + i);
+        v = _mm256_xor_si256(v, _mm256_srli_epi64(v, 47));
+        v = _mm256_xor_si256(v, _mm256_loadu_si256(
+                    reinterpret_cast<const __m256i*>(key) + i));
+        const auto hi = _mm256_shuffle_epi32(v, _MM_SHUFFLE(0, 3, 0, 1));
+        const auto lo_p = _mm256_mul_epu32(v, prime);
+        const auto hi_p = _mm256_mul_epu32(hi, prime);
+        _mm256_storeu_si256(a + i,
+                _mm256_add_epi64(lo_p, _mm256_slli_epi64(hi_p, 32)));
+    }
+}
+#elif defined(__SSE2__)
+inline void accumulate_simd(
+        acc_t& acc, const char* p, const unsigned char* key) noexcept
+{
+    auto* a = reinterpret_cast<__m128i*>(acc._a);
+    for(std::size_t i = 0; i != 4; ++i)
+    {
+        const auto data = _mm_loadu_si128(
+                reinterpret_cast<const __m128i*>(p) + i);
+        const auto k = _mm_loadu_si128(
+                reinterpret_cast<const __m128i*>(key) + i);
+        const auto dk = _mm_xor_si128(data, k);
+        const auto dk_hi = _mm_shuffle_epi32(dk, _MM_SHUFFLE(0, 3, 0, 1));
+        const auto product = _mm_mul_epu32(dk, dk_hi);
+        const auto swapped = _mm_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+        const auto sum = _mm_add_epi64(_mm_loadu_si128(a + i), swapped);
+        _mm_storeu_si128(a + i, _mm_add_epi64(product, sum));
+    }
+}
+inline void scramble_simd(acc_t& acc, const unsigned char* key) noexcept
+{
+    auto* a = reinterpret_cast<__m128i*>(acc._a);
+    const auto prime = _mm_set1_epi32(static_cast<int>(kPrime32_1));
+    for(std::size_t i = 0; i != 4; ++i)
+    {
+        auto v = _mm_loadu_si128(a + i);
+        v = _mm_xor_si128(v, _mm_srli_epi64(v, 47));
+        v = _mm_xor_si128(v, _mm_loadu_si128(
+                    reinterpret_cast<const __m128i*>(key) + i));
+        const auto hi = _mm_shuffle_epi32(v, _MM_SHUFFLE(0, 3, 0, 1));
+        const auto lo_p = _mm_mul_epu32(v, prime);
+        const auto hi_p = _mm_mul_epu32(hi, prime);
+        _mm_storeu_si128(a + i, _mm_add_epi64(lo_p, _mm_slli_epi64(hi_p, 32)));
+    }
+}
+#else
+inline void accumulate_simd(
+        acc_t& acc, const char* p, const unsigned char* key) noexcept
+{
+    accumulate_scalar(acc, p, key);
+}
+inline void scramble_simd(acc_t& acc, const unsigned char* key) noexcept
+{
+    scramble_scalar(acc, key);
+}
+#endif
+
+template<typename Accumulate, typename Scramble, typename C>
+constexpr std::uint64_t hash_long(const C* p, std::size_t len,
+        Accumulate accumulate, Scramble scramble) noexcept
+{
+    const auto* s = kSecret._b;
+    acc_t acc{{kPrime32_3, kPrime64_1, kPrime64_2, kPrime64_3,
+               kPrime64_4, kPrime32_2, kPrime64_5, kPrime32_1}};
+
+    const auto blocks = (len - 1) / kBlock;
+    for(std::size_t b = 0; b != blocks; ++b)
+    {
+        for(std::size_t i = 0; i != kStripesPerBlock; ++i)
+        {
+            accumulate(acc, p + b * kBlock + i * kStripe, s + i * 8);
+        }
+        scramble(acc, s + kSecretSize - kStripe);
+    }
+    const auto stripes = ((len - 1) - blocks * kBlock) / kStripe;
+    for(std::size_t i = 0; i != stripes; ++i)
+    {
+        accumulate(acc, p + blocks * kBlock + i * kStripe, s + i * 8);
+    }
+    accumulate(acc, p + len - kStripe, s + kSecretSize - kStripe - 7);
+
+    std::uint64_t result = len * kPrime64_1;
+    for(std::size_t i = 0; i != 4; ++i)
+    {
+        result += mum(acc._a[2 * i] ^ read64(s + 11 + 16 * i),
+                acc._a[2 * i + 1] ^ read64(s + 19 + 16 * i));
+    }
+    return avalanche(result);
+}
+
+}
+}
+
+struct fast_hash
+{
+    std::size_t operator()(const char* s, std::size_t l) const noexcept
+    {
+        namespace fh = details::fh;
+        if(INTERN__LIKELY(l <= 16))
+        {
+            return fh::hash_0to16(s, l);
+        }
+        if(l <= 128)
+        {
+            return fh::hash_17to128(s, l);
+        }
+        return fh::hash_long(s, l,
+                [](fh::acc_t& a, const char* p, const unsigned char* k)
+                {
+                    fh::accumulate_simd(a, p, k);
+                },
+                [](fh::acc_t& a, const unsigned char* k)
+                {
+                    fh::scramble_simd(a, k);
+                });
+    }
+
+    // Same result, without the vector code: usable in constant expressions
+    static constexpr std::size_t hash(const char* s, std::size_t l) noexcept
+    {
+        namespace fh = details::fh;
+        if(l <= 16)
+        {
+            return fh::hash_0to16(s, l);
+        }
+        if(l <= 128)
+        {
+            return fh::hash_17to128(s, l);
+        }
+        return fh::hash_long(s, l,
+                [](fh::acc_t& a, const char* p, const unsigned char* k)
+                {
+                    fh::accumulate_scalar(a, p, k);
+                },
+                [](fh::acc_t& a, const unsigned char* k)
+                {
+                    fh::scramble_scalar(a, k);
+                });
+    }
+};
+
+}
@@ -0,0 +1,347 @@
+#pragma once
+
+// The MIT License (MIT)
+//
+// Copyright (c) 2019 jh0x
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <intern/details/utils.hpp>
+#include <intern/flat_map.hpp>
+#include <intern/string_far.hpp>
+#include <intern/string_sso_tiny.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+namespace intern {
+
+// A column of interned strings stored as a struct of arrays: the far
+// pointers of the large values, densely packed, the inline bytes of the
+// small ones, densely packed, and a bitmap telling which row is which.
+// Filters scan one flat array of integers instead of branching on small()
+// and loading through a pointer for every row.
+//
+// Like flat_map, equality never reads the characters of a far string, so
+// all rows (and needles) must come from one interner and its scoped
+// interners.
+template<typename StringT>
+class interned_column
+{
+public:
+    using value_type = StringT;
+    using size_type = std::size_t;
+    using traits_type = typename StringT::traits_type;
+    using farT = string_far<traits_type>;
+
+    interned_column() = default;
+    template<typename It>
+    interned_column(It first, It last)
+    {
+        reserve(static_cast<size_type>(std::distance(first, last)));
+        for(; first != last; ++first)
+        {
+            push_back(*first);
+        }
+    }
+
+    size_type size() const noexcept { return _size; }
+    bool empty() const noexcept { return _size == 0; }
+    size_type far_count() const noexcept { return _far.size(); }
+    size_type small_count() const noexcept { return _small.size(); }
+
+    void reserve(size_type n)
+    {
+        _far_bits.reserve(_blocks(n));
+        _far_before.reserve(_blocks(n));
+    }
+
+    void push_back(const StringT& s)
+    {
+        if(_size % 64 == 0)
+        {
+            _far_bits.push_back(0);
+            _far_before.push_back(_far.size());
+        }
+        if(s.small())
+        {
+            _small.push_back(_payload(s.data(), s.size()));
+        }
+        else
+        {
+            _far_bits.back() |= std::uint64_t(1) << (_size % 64);
+            _far.push_back(s.data());
+        }
+        ++_size;
+    }
+
+    void clear() noexcept
+    {
+        _far_bits.clear();
+        _far_before.clear();
+        _far.clear();
+        _small.clear();
+        _size = 0;
+    }
+
+    bool small(size_type row) const noexcept
+    {
+        return !(_far_bits[row / 64] >> (row % 64) & 1);
+    }
+
+    StringT operator[](size_type row) const
+    {
+        const auto f = _far_rank(row);
+        if constexpr(StringT::sso_size != 0)
+        {
+            if(small(row))
+            {
+                return _make_small(_small[row - f]);
+            }
+        }
+        return _make_far(_far[f]);
+    }
+
+    // Bitmap of the rows equal to needle, bit (row % 64) of word (row / 64)
+    std::vector<std::uint64_t> find_equal(const StringT& needle) const
+    {
+        std::vector<std::uint64_t> out(_far_bits.size());
+        if(needle.small())
+        {
+            const auto p = _payload(needle.data(), needle.size());
+            _scan(out, true, [&](size_type i) { return _same(_small[i], p); });
+        }
+        else
+        {
+            const auto p = needle.data();
+            _scan(out, false, [&](size_type i) { return _far[i] == p; });
+        }
+        return out;
+    }
+
+    size_type count_equal(const StringT& needle) const noexcept
+    {
+        size_type n = 0;
+        if(needle.small())
+        {
+            const auto p = _payload(needle.data(), needle.size());
+            for(const auto& q : _small)
+            {
+                n += _same(q, p);
+            }
+        }
+        else
+        {
+            for(const auto f : _far)
+            {
+                n += f == needle.data();
+            }
+        }
+        return n;
+    }
+
+    // Number of different strings in the column
+    size_type count_distinct() const
+    {
+        flat_map<StringT, bool> seen;
+        for(const auto f : _far)
+        {
+            seen.try_emplace(_make_far(f));
+        }
+        if constexpr(StringT::sso_size != 0)
+        {
+            for(const auto& q : _small)
+            {
+                seen.try_emplace(_make_small(q));
+            }
+        }
+        return seen.size();
+    }
+
+    // The strings of the given rows, in that order. The far data of a few
+    // rows ahead is prefetched when the string type has to read its size.
+    template<typename RowIt, typename OutIt>
+    OutIt materialize(RowIt first, RowIt last, OutIt out) const
+    {
+        constexpr int kAhead = 8;
+        auto ahead = first;
+        for(int i = 0; _reads_size && i != kAhead && ahead != last; ++i)
+        {
+            _prefetch_row(*ahead++);
+        }
+        for(; first != last; ++first, ++out)
+        {
+            if(_reads_size && ahead != last)
+            {
+                _prefetch_row(*ahead++);
+            }
+            *out = (*this)[*first];
+        }
+        return out;
+    }
+
+    // Bring the lengths and first characters of the far rows in
+    // [first, first + n) into the cache
+    void prefetch(size_type first, size_type n) const noexcept
+    {
+        const auto last = std::min(first + n, _size);
+        if(first >= last)
+        {
+            return;
+        }
+        const auto end = last == _size ? _far.size() : _far_rank(last);
+        for(auto i = _far_rank(first); i != end; ++i)
+        {
+            __builtin_prefetch(_far[i] - 1);
+        }
+    }
+
+    size_type bytes() const noexcept
+    {
+        return _far_bits.capacity() * sizeof(std::uint64_t)
+            + _far_before.capacity() * sizeof(size_type)
+            + _far.capacity() * sizeof(const char*)
+            + _small.capacity() * sizeof(payload);
+    }
+
+private:
+    // The inline bytes of a small value, zero padded, size in the last byte
+    constexpr static size_type kWords = (StringT::sso_size + 8) / 8;
+    using payload = std::array<std::uint64_t, kWords>;
+    constexpr static bool _tiny =
+        std::is_same<StringT, string_sso_tiny<traits_type>>::value;
+    constexpr static bool _reads_size =
+        StringT::sso_size != 0 && !_tiny;
+
+    static size_type _blocks(size_type n) noexcept { return (n + 63) / 64; }
+
+    static payload _payload(const char* s, size_type sz) noexcept
+    {
+        payload p{};
+        auto raw = reinterpret_cast<char*>(p.data());
+        std::memcpy(raw, s, sz);
+        raw[sizeof(payload) - 1] = static_cast<char>(sz);
+        return p;
+    }
+
+    static bool _same(const payload& a, const payload& b) noexcept
+    {
+        std::uint64_t d = 0;
+        for(size_type i = 0; i != kWords; ++i)
+        {
+            d |= a[i] ^ b[i];
+        }
+        return d == 0;
+    }
+
+    static StringT _make_small(const payload& p)
+    {
+        const auto raw = reinterpret_cast<const char*>(p.data());
+        return StringT(raw,
+                static_cast<unsigned char>(raw[sizeof(payload) - 1]));
+    }
+
+    static StringT _make_far(const char* p)
+    {
+        if constexpr(StringT::sso_size == 0 || _tiny)
+        {
+            return StringT(farT(p));
+        }
+        else
+        {
+            return StringT(p, farT(p).size());
+        }
+    }
+
+    // Far rows before row
+    size_type _far_rank(size_type row) const noexcept
+    {
+        const auto below = (std::uint64_t(1) << (row % 64)) - 1;
+        return _far_before[row / 64]
+            + static_cast<size_type>(
+                    __builtin_popcountll(_far_bits[row / 64] & below));
+    }
+
+    void _prefetch_row(size_type row) const noexcept
+    {
+        if(!small(row))
+        {
+            __builtin_prefetch(_far[_far_rank(row)] - 1);
+        }
+    }
+
+    // Spread the low popcount(mask) bits of v over the set bits of mask
+    static std::uint64_t _deposit(std::uint64_t v, std::uint64_t mask) noexcept
+    {
+#if defined(__BMI2__)
+        return _pdep_u64(v, mask);
+#else
+        std::uint64_t r = 0;
+        for(; mask; mask &= mask - 1, v >>= 1)
+        {
+            r |= (v & 1) ? mask & (~mask + 1) : 0;
+        }
+        return r;
+#endif
+    }
+
+    // Block by block: match the block's entries of the dense array, then
+    // move the bits to the rows they belong to
+    template<typename Eq>
+    void _scan(std::vector<std::uint64_t>& out, bool small, Eq eq) const
+    {
+        for(size_type b = 0; b != _far_bits.size(); ++b)
+        {
+            auto mask = _far_bits[b];
+            auto at = _far_before[b];
+            if(small)
+            {
+                const auto rows = std::min<size_type>(64, _size - b * 64);
+                mask = ~mask & (rows == 64
+                        ? ~std::uint64_t(0)
+                        : (std::uint64_t(1) << rows) - 1);
+                at = b * 64 - at;
+            }
+            const auto n = static_cast<size_type>(__builtin_popcountll(mask));
+            std::uint64_t hits = 0;
+            for(size_type j = 0; j != n; ++j)
+            {
+                hits |= std::uint64_t(eq(at + j)) << j;
+            }
+            out[b] = _deposit(hits, mask);
+        }
+    }
+
+    std::vector<std::uint64_t> _far_bits;   // 1 = far row
+    std::vector<size_type> _far_before;     // far rows before each block
+    std::vector<const char*> _far;
+    std::vector<payload> _small;
+    size_type _size = 0;
+};
+
+}
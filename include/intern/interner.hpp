@@ -23,13 +23,41 @@
 // SOFTWARE.
 
 #include <intern/config.hpp>
+#include <intern/details/compact_index.hpp>
+#include <intern/details/front_cache.hpp>
+#include <intern/details/id_table.hpp>
+#include <intern/details/mapped_base.hpp>
+#include <intern/details/rank.hpp>
+#include <intern/details/reclaim.hpp>
+#include <intern/details/segments.hpp>
+#include <intern/details/stats.hpp>
 #include <intern/details/metadata.hpp>
+#include <intern/details/traits.hpp>
 #include <intern/details/utils.hpp>
 #include <intern/default_string_traits.hpp>
+#include <intern/frozen_interner.hpp>
+#include <intern/literal.hpp>
 #include <intern/string_far.hpp>
+#include <intern/string_id.hpp>
+#include <intern/string_ref.hpp>
 #include <intern/string_sso_tiny.hpp>
 #include <intern/string_sso_v1.hpp>
 #include <intern/string_sso_v2.hpp>
+#include <intern/string_sso_v3.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <optional>
+#ifdef INTERN_HAS_STRING_VIEW
+#include <string_view>
+#endif
+#include <utility>
+#include <vector>
 
 namespace intern
 {
@@ -40,6 +68,9 @@ template<size_t S, typename T> class string_sso_v1;
 template<typename ITraits, typename Traits = default_string_traits>
 class interner
 {
+    template<typename> friend class string_ref;
+    template<typename> friend class scoped_interner;
+
 public:
     using StringTraits = Traits;
     using hasherT = typename ITraits::hasherT;
@@ -49,20 +80,30 @@ public:
     static_assert(sizeof(stringF) == sizeof(char*), "Size problem");
     template<size_t S> using stringS1 = string_sso_v1<S, Traits>;
     template<size_t S> using stringS2 = string_sso_v2<S, Traits>;
+    template<size_t S> using stringS3 = string_sso_v3<S, Traits>;
 
+    // Where the strings are stored: ITraits::allocatorT when there is one
+    // (one per interner), the static ITraits::allocate otherwise
+    using allocatorT = typename details::allocator_of<ITraits>::type;
+
+    interner() = default;
+    explicit interner(allocatorT alloc) : _alloc{std::move(alloc)} {}
 
     stringF far(const char* s, typename Traits::size_type sz);
     stringF far(const std::string& s)
     {
-        return far(s.data(), s.size());
+        return far(s.data(), details::checked_size<Traits>(s.size()));
     }
     template<size_t N>
     stringF far(const char (&s)[N]) { return far(s, N - 1); }
+    // Literal with its own slot, interned on the first call only (see
+    // INTERN_LITERAL)
+    stringF far(const literal_slot& slot, const literal<hasherT>& lit);
 
     stringST tiny(const char* s, typename Traits::size_type sz);
     stringST tiny(const std::string& s)
     {
-        return tiny(s.data(), s.size());
+        return tiny(s.data(), details::checked_size<Traits>(s.size()));
     }
     template<size_t N>
     stringST tiny(const char (&s)[N]) { return tiny(s, N - 1); }
@@ -72,7 +113,7 @@ public:
     template<size_t S>
     stringS1<S> sso1(const std::string& s)
     {
-        return sso1<S>(s.data(), s.size());
+        return sso1<S>(s.data(), details::checked_size<Traits>(s.size()));
     }
     template<size_t S, size_t N>
     stringS1<S> sso1(const char (&s)[N]) { return sso1<S>(s, N - 1); }
@@ -83,7 +124,7 @@ public:
     template<size_t S>
     stringS2<S> sso2(const std::string& s)
     {
-        return sso2<S>(s.data(), s.size());
+        return sso2<S>(s.data(), details::checked_size<Traits>(s.size()));
     }
     template<size_t S, size_t N>
     stringS2<S> sso2(const char (&s)[N])
@@ -91,9 +132,297 @@ public:
         return sso2<S>(s, N - 1);
     }
 
+    template<size_t S>
+    stringS3<S> sso3(const char* s, typename Traits::size_type sz);
+    template<size_t S>
+    stringS3<S> sso3(const std::string& s)
+    {
+        return sso3<S>(s.data(), details::checked_size<Traits>(s.size()));
+    }
+    template<size_t S, size_t N>
+    stringS3<S> sso3(const char (&s)[N])
+    {
+        return sso3<S>(s, N - 1);
+    }
+
+    // Dense ids (Traits::metadata_store_id): strings are numbered 0, 1, 2,
+    // ... in the order they are first interned, and far(id) gives them back
+    // through a table of pointers. far(id) requires an id of this interner;
+    // find(id) also takes others, e.g. the invalid id of a scoped string.
+    string_id id(const char* s, typename Traits::size_type sz)
+    {
+        return far(s, sz).id();
+    }
+    string_id id(const std::string& s)
+    {
+        return id(s.data(), details::checked_size<Traits>(s.size()));
+    }
+    template<size_t N>
+    string_id id(const char (&s)[N]) { return id(s, N - 1); }
+    stringF far(string_id id) const noexcept
+    {
+        static_assert(Traits::metadata_store_id, "strings have no ids");
+        assert(id.value() < _ids.size());
+        return stringF{_ids[id.value()]};
+    }
+    std::optional<stringF> find(string_id id) const noexcept
+    {
+        static_assert(Traits::metadata_store_id, "strings have no ids");
+        if(const char* p = _ids.find(id.value()))
+        {
+            return stringF{p};
+        }
+        return std::nullopt;
+    }
+
+    // Reclaiming interners (ITraits::reclaim) only. Strings interned through
+    // ref() are removed once the last string_ref to them is gone. Strings
+    // that far(), tiny(), sso1() or sso2() ever handed out are kept for good.
+    using refT = string_ref<interner>;
+    refT ref(const char* s, typename Traits::size_type sz);
+    refT ref(const std::string& s)
+    {
+        return ref(s.data(), details::checked_size<Traits>(s.size()));
+    }
+    template<size_t N>
+    refT ref(const char (&s)[N]) { return ref(s, N - 1); }
+
+#ifdef INTERN_HAS_STRING_VIEW
+    // Batched versions of the above. All inputs of a batch are hashed and
+    // their buckets prefetched before the first probe so that the cache
+    // misses overlap. Results are written to out in input order.
+    template<typename OutIt>
+    OutIt far_batch(const std::string_view* in, std::size_t n, OutIt out)
+    {
+        return _batch<0>(in, n, out,
+                nullptr,
+                [](stringF f, size_type) { return f; });
+    }
+    template<typename OutIt>
+    OutIt tiny_batch(const std::string_view* in, std::size_t n, OutIt out)
+    {
+        return _batch<stringST::sso_size + 1>(in, n, out,
+                [](const char* s, size_type sz) { return stringST(s, sz); },
+                [](stringF f, size_type) { return stringST(f); });
+    }
+    template<size_t S, typename OutIt>
+    OutIt sso1_batch(const std::string_view* in, std::size_t n, OutIt out)
+    {
+        return _batch<stringS1<S>::sso_size + 1>(in, n, out,
+                [](const char* s, size_type sz) { return stringS1<S>(s, sz); },
+                [](stringF f, size_type sz) { return stringS1<S>(f.data(), sz); });
+    }
+    template<size_t S, typename OutIt>
+    OutIt sso2_batch(const std::string_view* in, std::size_t n, OutIt out)
+    {
+        return _batch<stringS2<S>::sso_size + 1>(in, n, out,
+                [](const char* s, size_type sz) { return stringS2<S>(s, sz); },
+                [](stringF f, size_type sz) { return stringS2<S>(f.data(), sz); });
+    }
+    template<size_t S, typename OutIt>
+    OutIt sso3_batch(const std::string_view* in, std::size_t n, OutIt out)
+    {
+        return _batch<stringS3<S>::sso_size + 1>(in, n, out,
+                [](const char* s, size_type sz) { return stringS3<S>(s, sz); },
+                [](stringF f, size_type sz) { return stringS3<S>(f.data(), sz); });
+    }
+
+    // Same, for any contiguous range of std::string_view (std::span,
+    // std::vector, std::array, ...)
+    template<typename Range, typename OutIt>
+    OutIt far_batch(const Range& in, OutIt out)
+    {
+        return far_batch(std::data(in), std::size(in), out);
+    }
+    template<typename Range, typename OutIt>
+    OutIt tiny_batch(const Range& in, OutIt out)
+    {
+        return tiny_batch(std::data(in), std::size(in), out);
+    }
+    template<size_t S, typename Range, typename OutIt>
+    OutIt sso1_batch(const Range& in, OutIt out)
+    {
+        return sso1_batch<S>(std::data(in), std::size(in), out);
+    }
+    template<size_t S, typename Range, typename OutIt>
+    OutIt sso2_batch(const Range& in, OutIt out)
+    {
+        return sso2_batch<S>(std::data(in), std::size(in), out);
+    }
+    template<size_t S, typename Range, typename OutIt>
+    OutIt sso3_batch(const Range& in, OutIt out)
+    {
+        return sso3_batch<S>(std::data(in), std::size(in), out);
+    }
+#endif
+
+    // Lookup only: the interned copy of s if there is one. Never allocates,
+    // so it is safe to call concurrently with far() on a concurrent
+    // interner.
+    std::optional<stringF> find(
+            const char* s, typename Traits::size_type sz) const
+    {
+        return _find(lookup_metadata{hasherT{}(s, sz), sz, s});
+    }
+    std::optional<stringF> find(const std::string& s) const
+    {
+        if(INTERN__UNLIKELY(s.size() > std::numeric_limits<size_type>::max()))
+        {
+            return std::nullopt;
+        }
+        return find(s.data(), static_cast<size_type>(s.size()));
+    }
+    template<size_t N>
+    std::optional<stringF> find(const char (&s)[N]) const
+    {
+        return find(s, N - 1);
+    }
+
+    // Number of distinct strings interned so far
+    std::size_t size() const noexcept { return _base.size() + _lookup.size(); }
+    // Memory held by the lookup structure (not counting the strings)
+    std::size_t index_bytes() const noexcept
+    {
+        return details::lookup_bytes(_lookup);
+    }
+    const allocatorT& allocator() const noexcept { return _alloc; }
+    // Strings whose rank had to change to make room for others
+    // (Traits::metadata_store_rank)
+    std::size_t relabeled() const noexcept
+    {
+        static_assert(Traits::metadata_store_rank, "strings are not ranked");
+        return _ranks.relabeled();
+    }
+    // Bytes of removed strings waiting to be reused (ITraits::reclaim)
+    std::size_t free_bytes() const noexcept
+    {
+        static_assert(reclaiming, "not a reclaiming interner");
+        return _reclaim._free.bytes();
+    }
+
+    // Hits and misses of the per thread front cache (ITraits::front_cache),
+    // summed over all threads and all interners of this type
+    static details::front_cache_stats front_cache_stats()
+    {
+        static_assert(front_cache_size != 0, "no front cache configured");
+        return front_cacheT<>::stats();
+    }
+
+    // Lookup counters, new string lengths and a picture of the memory in
+    // use (ITraits::statistics, see details::interner_stats). Cheap enough
+    // to be polled while other threads intern: the counters are never
+    // locked. The sizes are read as they are, so on an interner that is
+    // not concurrent they may be off while far() runs.
+    details::interner_stats stats() const;
+    // Strings of the compact index by the number of 16 slot groups a
+    // lookup has to probe to find them: [0] one, [1] two, ... Walks the
+    // whole index, must not race with far().
+    std::vector<std::size_t> probe_lengths() const
+    {
+        static_assert(compact, "only the compact index tells probe lengths");
+        return _lookup.probe_lengths(
+                [this](std::uint32_t o) { return _address(o); });
+    }
+
+    // Read-only snapshot of everything interned so far. The snapshot hands
+    // out the very same string_far values. Must not race with far().
+    using frozenT = frozen_interner<Traits, hasherT>;
+    frozenT freeze() const;
+
+    // Writes every string interned so far, together with a ready to use
+    // index, to a file that load() maps back without hashing or copying
+    // anything. Must not race with far().
+    bool save(const char* path) const;
+    // Maps a file written by save() as a read-only layer that is searched
+    // before anything else; strings interned afterwards go to the
+    // allocator as usual. Only on an empty interner. The file has to stay
+    // unchanged while it is mapped (save() replaces files by renaming).
+    bool load(const char* path);
+
 private:
-    using lookupT = typename ITraits::template lookupT<
-        details::lookup_metadata<Traits>, string_far<Traits>>;
+    using size_type = typename Traits::size_type;
+    using lookup_metadata = details::lookup_metadata<Traits>;
+    constexpr static bool compact = details::is_compact<ITraits>::value;
+    static_assert(!(compact && details::is_concurrent<ITraits>::value),
+            "the compact index cannot be shared between threads");
+    static_assert(!(details::is_concurrent<ITraits>::value
+                && details::has_allocator<ITraits>::value),
+            "concurrent interners allocate through the static ITraits::allocate");
+
+    // Either ITraits::lookupT or the compact index (ITraits::compact_index)
+    template<typename I, bool = compact>
+    struct lookup_of
+    {
+        using type = typename I::template lookupT<lookup_metadata, stringF>;
+    };
+    template<typename I>
+    struct lookup_of<I, true>
+    {
+        using type = details::compact_index<Traits, hasherT>;
+    };
+    using lookupT = typename lookup_of<ITraits>::type;
+
+    constexpr static std::size_t front_cache_size =
+        details::front_cache_size<ITraits>::value;
+
+    constexpr static bool reclaiming = details::is_reclaiming<ITraits>::value;
+    constexpr static bool statistics = details::has_statistics<ITraits>::value;
+    static_assert(!reclaiming || !(compact || front_cache_size
+                || details::is_concurrent<ITraits>::value),
+            "reclaiming interners cannot be compact, concurrent or cached");
+    static_assert(!(reclaiming && Traits::metadata_store_id),
+            "ids are never reused, strings with one cannot be reclaimed");
+    static_assert(!(details::is_concurrent<ITraits>::value
+                && Traits::metadata_store_rank),
+            "ranks change as strings are added, they cannot be shared");
+    using refcount = details::refcount;
+    template<std::size_t N = front_cache_size>
+    using front_cacheT = details::front_cache<Traits, interner, N>;
+
+    // Arena pointers <-> 32 bit offsets for the compact index
+    std::uint32_t _offset(const char* p) const noexcept
+    {
+        return _alloc.offset(p);
+    }
+    const char* _address(std::uint32_t o) const noexcept
+    {
+        return _alloc.address(o);
+    }
+
+    stringF _far(const lookup_metadata& lm);
+    stringF _far_shared(const lookup_metadata& lm);
+    std::optional<stringF> _find(const lookup_metadata& lm) const;
+    stringF _store(const lookup_metadata& lm);
+    static refcount::type& _count(const char* data) noexcept
+    {
+        const auto header =
+            details::header_bytes<Traits>(stringF{data}.size());
+        return *reinterpret_cast<refcount::type*>(const_cast<char*>(
+                    data - header - sizeof(refcount::type)));
+    }
+    void _acquire(const char* data) noexcept { ++_count(data); }
+    void _release(const char* data) noexcept;
+
+    // (hasherT hash, data) of every string
+    std::vector<std::pair<std::size_t, const char*>> _entries() const;
+
+#ifdef INTERN_HAS_STRING_VIEW
+    // Strings shorter than Small are built by make_small, the rest are
+    // interned and handed to make_far.
+    template<std::size_t Small, typename OutIt, typename MS, typename MF>
+    OutIt _batch(const std::string_view* in, std::size_t n, OutIt out,
+            MS make_small, MF make_far);
+#endif
+
+    details::instance_id<front_cache_size != 0> _id;
+    details::stats_state<statistics, details::is_concurrent<ITraits>::value>
+        _stats;
+    details::reclaim_state<reclaiming> _reclaim;
+    details::id_table<Traits::metadata_store_id> _ids;
+    details::segments<std::atomic<const char*>> _literals;
+    details::rank_order<Traits, Traits::metadata_store_rank> _ranks;
+    allocatorT _alloc;
+    details::mapped_base<Traits, hasherT> _base;
     lookupT _lookup;
 };
 
@@ -101,32 +430,360 @@ template<typename ITraits, typename Traits>
 string_far<Traits> interner<ITraits, Traits>::far(
         const char* s, typename Traits::size_type sz)
 {
-    // Do we already have it?
-    using metadata = details::metadata<Traits>;
-    using lookup_metadata = details::lookup_metadata<Traits>;
-    lookup_metadata lm{hasherT{}(s, sz), sz, s};
-    auto it = _lookup.find(lm);
-    if( INTERN__LIKELY( it != _lookup.end() ) )
+    return _far(lookup_metadata{hasherT{}(s, sz), sz, s});
+}
+
+template<typename ITraits, typename Traits>
+string_far<Traits> interner<ITraits, Traits>::far(
+        const literal_slot& slot, const literal<hasherT>& lit)
+{
+    auto& cached = _literals.at(slot.index());
+    if(const char* p = cached.load(std::memory_order_acquire))
     {
-        return it->second;
+        return stringF{p};
     }
+    const auto sz = static_cast<size_type>(lit._size);
+    const auto h = lit.hashed ? lit._hash : hasherT{}(lit._data, sz);
+    const auto res = _far(lookup_metadata{h, sz, lit._data});
+    cached.store(res.data(), std::memory_order_release);
+    return res;
+}
 
-    // Add it to the store:
-    void* mem = ITraits::allocate(
-            sizeof(metadata) + sz + 1, alignof(metadata));
-    metadata* m = new(mem) metadata{lm._len};
-    Traits::copy(m->_data, s, sz);
-    m->_data[sz] = '\0'; // <-- FIXME: do not do if zeroed out
+template<typename ITraits, typename Traits>
+string_far<Traits> interner<ITraits, Traits>::_far(const lookup_metadata& lm)
+{
+    if constexpr(front_cache_size != 0)
+    {
+        // A hit does not touch anything shared with other threads
+        auto& cache = front_cacheT<>::local();
+        if(const char* p = cache.find(_id._value, lm._hash, lm._data, lm._len))
+        {
+            _stats.lookup();
+            return stringF{p};
+        }
+        const auto res = _far_shared(lm);
+        cache.put(_id._value, lm._hash, res.data(), lm._len);
+        return res;
+    }
+    else if constexpr(reclaiming)
+    {
+        // Untracked copies from now on
+        const auto res = _far_shared(lm);
+        _count(res.data()) |= refcount::kPinned;
+        return res;
+    }
+    else
+    {
+        return _far_shared(lm);
+    }
+}
+
+template<typename ITraits, typename Traits>
+string_far<Traits> interner<ITraits, Traits>::_far_shared(
+        const lookup_metadata& lm)
+{
+    _stats.lookup();
+    if(INTERN__UNLIKELY(!_base.empty()))
+    {
+        if(const char* p = _base.find(lm._hash, lm._data, lm._len))
+        {
+            return stringF{p};
+        }
+    }
+    if constexpr(details::is_concurrent<ITraits>::value)
+    {
+        // Hits only need the shared lock of one submap
+        stringF res{nullptr};
+        if( INTERN__LIKELY( _lookup.if_contains(
+                        lm, [&res](const auto& v) { res = v.second; }) ) )
+        {
+            return res;
+        }
+
+        // Miss: allocate under the exclusive submap lock so that two
+        // threads racing on the same string agree on a single copy.
+        _lookup.lazy_emplace_l(lm,
+                [&res](const auto& v) { res = v.second; },
+                [&](const auto& ctor)
+                {
+                    res = _store(lm);
+                    ctor(lookup_metadata{lm._hash, lm._len, res.data()}, res);
+                });
+        return res;
+    }
+    else if constexpr(compact)
+    {
+        const auto address = [this](std::uint32_t o) { return _address(o); };
+        const auto off = _lookup.find(lm, address);
+        if( INTERN__LIKELY( off != lookupT::npos ) )
+        {
+            return stringF{_address(off)};
+        }
+
+        stringF res = _store(lm);
+        _lookup.insert(lm._hash, _offset(res.data()), address);
+        return res;
+    }
+    else
+    {
+        // Do we already have it?
+        auto it = _lookup.find(lm);
+        if( INTERN__LIKELY( it != _lookup.end() ) )
+        {
+            return it->second;
+        }
+
+        // Add it to the store and link it:
+        stringF res = _store(lm);
+        _lookup.insert(std::make_pair(
+                    lookup_metadata{lm._hash, lm._len, res.data()}, res));
+        return res;
+    }
+}
+
+template<typename ITraits, typename Traits>
+std::optional<string_far<Traits>> interner<ITraits, Traits>::_find(
+        const lookup_metadata& lm) const
+{
+    if(INTERN__UNLIKELY(!_base.empty()))
+    {
+        if(const char* p = _base.find(lm._hash, lm._data, lm._len))
+        {
+            return stringF{p};
+        }
+    }
+    if constexpr(details::is_concurrent<ITraits>::value)
+    {
+        std::optional<stringF> res;
+        _lookup.if_contains(lm, [&res](const auto& v) { res = v.second; });
+        return res;
+    }
+    else if constexpr(compact)
+    {
+        const auto off = _lookup.find(lm,
+                [this](std::uint32_t o) { return _address(o); });
+        if(off != lookupT::npos)
+        {
+            return stringF{_address(off)};
+        }
+        return std::nullopt;
+    }
+    else
+    {
+        const auto it = _lookup.find(lm);
+        if(it != _lookup.end())
+        {
+            return it->second;
+        }
+        return std::nullopt;
+    }
+}
 
-    // Lookup metadata should point to the store
-    lm._data = m->_data;
+template<typename ITraits, typename Traits>
+string_far<Traits> interner<ITraits, Traits>::_store(const lookup_metadata& lm)
+{
+    using metadata = details::metadata<Traits>;
+    const auto sz = lm._len;
+    const auto header = details::header_bytes<Traits>(sz);
+    _stats.store(sz);
+    void* mem;
+    if constexpr(reclaiming)
+    {
+        // Blocks of a size class, recycled when possible
+        const auto block = details::free_lists::block_size(
+                sizeof(refcount::type) + header + sz + 1);
+        mem = _reclaim._free.pop(block);
+        if(!mem)
+        {
+            mem = _alloc.allocate(block, refcount::kBlockAlign);
+        }
+        auto* count = new(mem) refcount::type{0};
+        mem = count + 1;
+    }
+    else
+    {
+        mem = _alloc.allocate(header + sz + 1, alignof(metadata));
+    }
+    metadata* m = details::make_metadata<Traits>(mem, sz, lm._hash);
+    Traits::copy(m->_data, lm._data, sz);
+    m->_data[sz] = '\0'; // <-- FIXME: do not do if zeroed out
+    if constexpr(Traits::metadata_store_id)
+    {
+        // Only complete strings can be reached through their id
+        const auto id = _ids.next();
+        m->_id = id;
+        _ids.publish(id, m->_data);
+    }
+    if constexpr(Traits::metadata_store_rank)
+    {
+        _ranks.insert(m->_data);
+    }
+    return stringF{m->_data};
+}
 
-    // And store the link:
-    string_far<Traits> res{m->_data};
-    _lookup.insert(std::make_pair(lm, res));
+template<typename ITraits, typename Traits>
+details::interner_stats interner<ITraits, Traits>::stats() const
+{
+    static_assert(statistics, "no statistics configured");
+    auto res = _stats.read();
+    res.distinct = size();
+    res.index_bytes = index_bytes();
+    if constexpr(details::has_capacity<lookupT>::value)
+    {
+        const auto capacity = _lookup.capacity();
+        res.load_factor = capacity ? double(_lookup.size()) / capacity : 0.0;
+    }
+    if constexpr(details::has_usage<allocatorT>::value)
+    {
+        res.arena_used = _alloc.used();
+        res.arena_reserved = _alloc.reserved();
+    }
     return res;
 }
 
+template<typename ITraits, typename Traits>
+string_ref<interner<ITraits, Traits>> interner<ITraits, Traits>::ref(
+        const char* s, typename Traits::size_type sz)
+{
+    static_assert(reclaiming, "not a reclaiming interner");
+    const auto res = _far_shared(lookup_metadata{hasherT{}(s, sz), sz, s});
+    ++_count(res.data());
+    return refT{this, res};
+}
+
+template<typename ITraits, typename Traits>
+void interner<ITraits, Traits>::_release(const char* data) noexcept
+{
+    if(--_count(data) != 0)
+    {
+        return;
+    }
+    const auto sz = stringF{data}.size();
+    const auto header = details::header_bytes<Traits>(sz);
+    _lookup.erase(lookup_metadata{hasherT{}(data, sz), sz, data});
+    if constexpr(Traits::metadata_store_rank)
+    {
+        _ranks.erase(data);
+    }
+    _reclaim._free.push(
+            const_cast<char*>(data) - header - sizeof(refcount::type),
+            details::free_lists::block_size(
+                sizeof(refcount::type) + header + sz + 1));
+}
+
+#ifdef INTERN_HAS_STRING_VIEW
+template<typename ITraits, typename Traits>
+template<std::size_t Small, typename OutIt, typename MS, typename MF>
+OutIt interner<ITraits, Traits>::_batch(
+        const std::string_view* in, std::size_t n, OutIt out,
+        MS make_small, MF make_far)
+{
+    constexpr std::size_t kBatch = 16;
+    std::size_t hashes[kBatch];
+    for(std::size_t base = 0; base < n; base += kBatch)
+    {
+        const auto* chunk = in + base;
+        const auto cnt = std::min(kBatch, n - base);
+
+        // Stage 1: hash everything and get the buckets on their way
+        for(std::size_t i = 0; i != cnt; ++i)
+        {
+            const size_type sz = details::checked_size<Traits>(chunk[i].size());
+            if(sz < Small)
+            {
+                continue;
+            }
+            hashes[i] = hasherT{}(chunk[i].data(), sz);
+            if constexpr(details::has_prefetch<lookupT, lookup_metadata>::value)
+            {
+                _lookup.prefetch(lookup_metadata{hashes[i], sz, chunk[i].data()});
+            }
+        }
+
+        // Stage 2: probe (and insert)
+        for(std::size_t i = 0; i != cnt; ++i)
+        {
+            const char* s = chunk[i].data();
+            const size_type sz = details::checked_size<Traits>(chunk[i].size());
+            if constexpr(Small > 0)
+            {
+                if(sz < Small)
+                {
+                    *out++ = make_small(s, sz);
+                    continue;
+                }
+            }
+            *out++ = make_far(_far(lookup_metadata{hashes[i], sz, s}), sz);
+        }
+    }
+    return out;
+}
+#endif
+
+template<typename ITraits, typename Traits>
+std::vector<std::pair<std::size_t, const char*>>
+interner<ITraits, Traits>::_entries() const
+{
+    std::vector<std::pair<std::size_t, const char*>> entries;
+    entries.reserve(size());
+    // Neither the mapped base nor the compact index keep the full hash
+    _base.for_each([&entries](const char* p)
+    {
+        const stringF s{p};
+        entries.emplace_back(hasherT{}(s.data(), s.size()), s.data());
+    });
+    if constexpr(compact)
+    {
+        _lookup.for_each([this, &entries](std::uint32_t off)
+        {
+            const stringF s{_address(off)};
+            entries.emplace_back(hasherT{}(s.data(), s.size()), s.data());
+        });
+    }
+    else
+    {
+        for(const auto& kv : _lookup)
+        {
+            entries.emplace_back(kv.first._hash, kv.second.data());
+        }
+    }
+    return entries;
+}
+
+template<typename ITraits, typename Traits>
+frozen_interner<Traits, typename ITraits::hasherT>
+interner<ITraits, Traits>::freeze() const
+{
+    return frozenT{_entries()};
+}
+
+template<typename ITraits, typename Traits>
+bool interner<ITraits, Traits>::save(const char* path) const
+{
+    return details::mapped_base<Traits, hasherT>::write(path, _entries());
+}
+
+template<typename ITraits, typename Traits>
+bool interner<ITraits, Traits>::load(const char* path)
+{
+    static_assert(!reclaiming, "mapped strings cannot be reclaimed");
+    static_assert(!Traits::metadata_store_rank,
+            "mapped strings cannot be ranked again");
+    if(size() != 0 || !_base.open(path))
+    {
+        return false;
+    }
+    if constexpr(Traits::metadata_store_id)
+    {
+        // The ids stay those of the interner that saved the file
+        _base.for_each([this](const char* p)
+        {
+            _ids.set(stringF{p}.id().value(), p);
+        });
+    }
+    return true;
+}
+
 template<typename ITraits, typename Traits>
 string_sso_tiny<Traits> interner<ITraits, Traits>::tiny(
         const char* s, typename Traits::size_type sz)
@@ -165,5 +822,18 @@ string_sso_v2<S, Traits> interner<ITraits, Traits>::sso2(
     return stringS2<S>(far(s, sz).data(), sz);
 }
 
+template<typename ITraits, typename Traits>
+template<size_t S>
+string_sso_v3<S, Traits> interner<ITraits, Traits>::sso3(
+        const char* s, typename Traits::size_type sz)
+{
+    static_assert(sizeof(stringS3<S>) == S, "Size problem");
+    if(sz <= stringS3<S>::sso_size)
+    {
+        return stringS3<S>(s, sz);
+    }
+    return stringS3<S>(far(s, sz).data(), sz);
+}
+
 }
 
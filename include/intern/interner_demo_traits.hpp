@@ -21,11 +21,16 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#include <intern/arena.hpp>
 #include <intern/config.hpp>
+#include <intern/hash.hpp>
 
+#include <atomic>
 #include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <memory>
+#include <shared_mutex>
 #ifdef INTERN_HAS_STRING_VIEW
 #include <string_view>
 #endif
@@ -35,26 +40,16 @@
 namespace intern
 {
 
-#ifdef __cpp_exceptions
-[[noreturn]] inline void _bad_alloc() {
-    throw std::bad_alloc{};
-}
-#else
-[[noreturn]] inline void _bad_alloc() noexcept {
-    std::abort();
-}
-#endif
-
 struct interner_sample_hash
 {
-    std::size_t operator()(const char* s, std::size_t l) const
+    std::size_t operator()(const char* s, std::size_t l) const noexcept
     {
-#ifdef INTERN_HAS_STRING_VIEW
-        auto sv = std::string_view(s, l);
-        return std::hash<std::string_view>{}(sv);
-#else
-        return std::_Hash_impl::hash(s, l);
-#endif
+        return fast_hash{}(s, l);
+    }
+    // Lets literals be hashed at compile time (see literal)
+    static constexpr std::size_t hash(const char* s, std::size_t l) noexcept
+    {
+        return fast_hash::hash(s, l);
     }
 };
 
@@ -77,6 +72,15 @@ struct interner_sample_traits
         }
         return ptr;
     }
+    // Arena pointers as 32 bit offsets (see compact_index)
+    static std::uint32_t offset(const char* p) noexcept
+    {
+        return static_cast<std::uint32_t>(p - _buf());
+    }
+    static const char* address(std::uint32_t o) noexcept
+    {
+        return _buf() + o;
+    }
     static char* _buf() noexcept
     {
         alignas(8) static char buf[N]{};
@@ -90,5 +94,85 @@ struct interner_sample_traits
 
 };
 
-}
+// Same arena, but indexed by details::compact_index: 5 bytes per slot
+template<std::size_t N>
+struct interner_sample_compact_traits : interner_sample_traits<N>
+{
+    static_assert(N <= std::uint32_t(-1), "offsets have to fit in 32 bits");
+    constexpr static auto compact_index = true;
+};
+
+// Same as above but safe to share between threads: the lookup is split
+// into 2^6 submaps each guarded by its own lock and the buffer is carved
+// with an atomic bump pointer.
+template<std::size_t N, typename MutexT = std::shared_mutex>
+struct interner_sample_concurrent_traits
+{
+    constexpr static auto concurrent = true;
+
+    using hasherT = interner_sample_hash;
+    template<typename K, typename V>
+    using lookupT = phmap::parallel_flat_hash_map<K, V,
+          phmap::Hash<K>, phmap::EqualTo<K>,
+          std::allocator<std::pair<const K, V>>, 6, MutexT>;
+
+    static void* allocate(std::size_t s, std::size_t a)
+        noexcept(noexcept(_bad_alloc()))
+    {
+        auto off = _off().load(std::memory_order_relaxed);
+        std::size_t begin;
+        do
+        {
+            begin = ((off + (a - 1)) & -a);
+            if(begin + s > N)
+            {
+                _bad_alloc();
+            }
+        }
+        while(!_off().compare_exchange_weak(
+                    off, begin + s, std::memory_order_relaxed));
+        return _buf() + begin;
+    }
+    static char* _buf() noexcept
+    {
+        alignas(8) static char buf[N]{};
+        return buf;
+    }
+    static std::atomic<std::size_t>& _off() noexcept
+    {
+        static std::atomic<std::size_t> off;
+        return off;
+    }
+};
+
+// Concurrent interner with a per thread cache of 1024 recent strings in
+// front of it: hot strings stop going to the shared submaps
+template<std::size_t N, typename MutexT = std::shared_mutex>
+struct interner_sample_cached_traits
+    : interner_sample_concurrent_traits<N, MutexT>
+{
+    constexpr static std::size_t front_cache = 1024;
+};
 
+// Growable instead of fixed size: every interner owns an arena
+// (ITraits::allocatorT) and may use huge pages
+template<arena_pages Pages = arena_pages::normal>
+struct interner_sample_arena_traits
+{
+    using hasherT = interner_sample_hash;
+    template<typename K, typename V>
+    using lookupT = phmap::parallel_flat_hash_map<K, V>;
+
+    struct allocatorT : arena
+    {
+        allocatorT() noexcept : arena{std::size_t(64) << 10, Pages} {}
+    };
+};
+
+// Growable arena and strings that go away with their last string_ref
+struct interner_sample_reclaim_traits : interner_sample_arena_traits<>
+{
+    constexpr static auto reclaim = true;
+};
+
+}
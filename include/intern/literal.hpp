@@ -0,0 +1,105 @@
+#pragma once
+
+// The MIT License (MIT)
+//
+// Copyright (c) 2019 jh0x
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <intern/details/traits.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace intern
+{
+
+// A string literal and its hash. The hash is computed at compile time when
+// HasherT has a constexpr static hash(s, l) (fast_hash does), and left to
+// the interner otherwise.
+template<typename HasherT>
+struct literal
+{
+    template<std::size_t N>
+    constexpr literal(const char (&s)[N]) noexcept
+        : _data{s}
+        , _size{N - 1}
+        , _hash{_hash_of(s, N - 1)}
+    {}
+
+    constexpr static bool hashed = details::has_static_hash<HasherT>::value;
+
+    const char* _data;
+    std::size_t _size;
+    std::size_t _hash;
+
+private:
+    constexpr static std::size_t _hash_of(const char* s, std::size_t l)
+    {
+        if constexpr(hashed)
+        {
+            return HasherT::hash(s, l);
+        }
+        else
+        {
+            return 0;
+        }
+    }
+};
+
+// Where every interner keeps the string_far of one literal: each slot gets
+// its own index the first time it is constructed. Meant to be a static
+// next to the literal (see INTERN_LITERAL).
+class literal_slot
+{
+public:
+    literal_slot() noexcept
+        : _index{_next().fetch_add(1, std::memory_order_relaxed)}
+    {}
+    literal_slot(const literal_slot&) = delete;
+    literal_slot& operator=(const literal_slot&) = delete;
+
+    std::uint32_t index() const noexcept { return _index; }
+
+private:
+    static std::atomic<std::uint32_t>& _next() noexcept
+    {
+        static std::atomic<std::uint32_t> next{0};
+        return next;
+    }
+
+    std::uint32_t _index;
+};
+
+}
+
+// The interned copy of a string literal: INTERN_LITERAL(i, "NYSE"). Hashed
+// at compile time when the hasher allows it; the first call with a given
+// interner interns the literal, later ones return the string_far kept for
+// this call site with no hashing and no probing.
+#define INTERN_LITERAL(interner, s)                                     \
+    ([](auto& intern__i) {                                              \
+        using intern__hasher =                                          \
+            typename std::decay_t<decltype(intern__i)>::hasherT;        \
+        constexpr ::intern::literal<intern__hasher> intern__lit{s};     \
+        static const ::intern::literal_slot intern__slot;               \
+        return intern__i.far(intern__slot, intern__lit);                \
+    }(interner))
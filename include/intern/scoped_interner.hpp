@@ -0,0 +1,229 @@
+#pragma once
+
+// The MIT License (MIT)
+//
+// Copyright (c) 2019 jh0x
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <intern/arena.hpp>
+#include <intern/details/metadata.hpp>
+#include <intern/details/utils.hpp>
+#include <intern/string_far.hpp>
+#include <intern/string_sso_tiny.hpp>
+#include <intern/string_sso_v1.hpp>
+#include <intern/string_sso_v2.hpp>
+#include <intern/string_sso_v3.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace intern
+{
+
+// Short lived interner on top of a long lived one, e.g. for one request.
+// Strings the parent already has come from the parent (lookup only, the
+// parent is never modified); the others are copied into the scope's own
+// arena. mark() / rollback() forget everything interned since the mark in
+// O(1): the arena pointer moves back and the table entries are dropped by
+// truncating an array, nothing is destroyed one by one.
+//
+// The table is open addressing over a sparse set: slots hold indices into
+// the dense array of entries and a slot is only live when its entry points
+// back at it. Entries are only ever removed newest first, so the probe
+// sequences of the remaining ones stay intact.
+//
+// Strings handed out are valid until a rollback past them (or the end of
+// the scope); parent strings as long as the parent.
+template<typename Parent>
+class scoped_interner
+{
+public:
+    using StringTraits = typename Parent::StringTraits;
+    using hasherT = typename Parent::hasherT;
+    using stringF = typename Parent::stringF;
+    using stringST = typename Parent::stringST;
+    template<size_t S> using stringS1 = typename Parent::template stringS1<S>;
+    template<size_t S> using stringS2 = typename Parent::template stringS2<S>;
+    template<size_t S> using stringS3 = typename Parent::template stringS3<S>;
+    using size_type = typename StringTraits::size_type;
+
+    explicit scoped_interner(const Parent& parent,
+            std::size_t first_chunk = std::size_t(4) << 10)
+        : _parent{parent}
+        , _arena{first_chunk}
+        , _slots(kMinSlots, 0)
+    {}
+    scoped_interner(const scoped_interner&) = delete;
+    scoped_interner& operator=(const scoped_interner&) = delete;
+
+    stringF far(const char* s, size_type sz);
+    stringF far(const std::string& s)
+    {
+        return far(s.data(), details::checked_size<StringTraits>(s.size()));
+    }
+    template<size_t N>
+    stringF far(const char (&s)[N]) { return far(s, N - 1); }
+
+    stringST tiny(const char* s, size_type sz)
+    {
+        return sz <= stringST::sso_size ? stringST(s, sz) : stringST(far(s, sz));
+    }
+    template<size_t S>
+    stringS1<S> sso1(const char* s, size_type sz)
+    {
+        return sz <= stringS1<S>::sso_size
+            ? stringS1<S>(s, sz) : stringS1<S>(far(s, sz).data(), sz);
+    }
+    template<size_t S>
+    stringS2<S> sso2(const char* s, size_type sz)
+    {
+        return sz <= stringS2<S>::sso_size
+            ? stringS2<S>(s, sz) : stringS2<S>(far(s, sz).data(), sz);
+    }
+    template<size_t S>
+    stringS3<S> sso3(const char* s, size_type sz)
+    {
+        return sz <= stringS3<S>::sso_size
+            ? stringS3<S>(s, sz) : stringS3<S>(far(s, sz).data(), sz);
+    }
+
+    struct marker
+    {
+        arena::marker _arena;
+        std::size_t _entries;
+    };
+    marker mark() const noexcept { return {_arena.mark(), _entries.size()}; }
+    void rollback(const marker& m) noexcept
+    {
+        _entries.resize(m._entries);
+        _arena.rollback(m._arena);
+    }
+    // Back to an empty scope; memory is kept for the next round
+    void clear() noexcept { rollback(marker{{0, nullptr, 0}, 0}); }
+
+    // Strings owned by the scope (not counting the parent's)
+    std::size_t size() const noexcept { return _entries.size(); }
+    const arena& allocator() const noexcept { return _arena; }
+
+private:
+    using metadata = details::metadata<StringTraits>;
+    using lookup_metadata = details::lookup_metadata<StringTraits>;
+    constexpr static std::size_t kMinSlots = 64;
+
+    struct entry
+    {
+        std::size_t _hash;
+        const char* _data;
+        std::size_t _slot;
+    };
+
+    bool _live(std::size_t pos) const noexcept
+    {
+        const auto v = _slots[pos];
+        return v < _entries.size() && _entries[v]._slot == pos;
+    }
+    // Slot holding s, or the empty slot where it goes
+    std::size_t _probe(std::size_t hash, const char* s, size_type sz)
+        const noexcept
+    {
+        const auto mask = _slots.size() - 1;
+        for(auto pos = hash & mask;; pos = (pos + 1) & mask)
+        {
+            if(!_live(pos))
+            {
+                return pos;
+            }
+            const auto& e = _entries[_slots[pos]];
+            if(e._hash == hash)
+            {
+                const stringF f{e._data};
+                if(f.size() == sz
+                        && details::traits_eq<StringTraits>(e._data, s, sz))
+                {
+                    return pos;
+                }
+            }
+        }
+    }
+    void _grow();
+
+    const Parent& _parent;
+    arena _arena;
+    std::vector<std::uint32_t> _slots;
+    std::vector<entry> _entries;
+};
+
+template<typename Parent>
+auto scoped_interner<Parent>::far(const char* s, size_type sz) -> stringF
+{
+    const auto hash = hasherT{}(s, sz);
+    if(auto p = _parent._find(lookup_metadata{hash, sz, s}))
+    {
+        return *p;
+    }
+
+    auto pos = _probe(hash, s, sz);
+    if(_live(pos))
+    {
+        return stringF{_entries[_slots[pos]]._data};
+    }
+    if(INTERN__UNLIKELY((_entries.size() + 1) * 2 > _slots.size()))
+    {
+        _grow();
+        pos = _probe(hash, s, sz);
+    }
+
+    const auto header = details::header_bytes<StringTraits>(sz);
+    void* mem = _arena.allocate(header + sz + 1, alignof(metadata));
+    metadata* m = details::make_metadata<StringTraits>(mem, sz, hash);
+    StringTraits::copy(m->_data, s, sz);
+    m->_data[sz] = '\0';
+
+    _slots[pos] = static_cast<std::uint32_t>(_entries.size());
+    _entries.push_back(entry{hash, m->_data, pos});
+    return stringF{m->_data};
+}
+
+template<typename Parent>
+void scoped_interner<Parent>::_grow()
+{
+    // Reinserted oldest first, which keeps the newest-first removal valid
+    _slots.assign(_slots.size() * 2, 0);
+    const auto mask = _slots.size() - 1;
+    for(auto& e : _entries)
+    {
+        e._slot = std::size_t(-1);
+    }
+    for(std::size_t k = 0; k != _entries.size(); ++k)
+    {
+        auto pos = _entries[k]._hash & mask;
+        while(_live(pos))
+        {
+            pos = (pos + 1) & mask;
+        }
+        _slots[pos] = static_cast<std::uint32_t>(k);
+        _entries[k]._slot = pos;
+    }
+}
+
+}
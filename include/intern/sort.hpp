@@ -0,0 +1,351 @@
+#pragma once
+
+// The MIT License (MIT)
+//
+// Copyright (c) 2019 jh0x
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <intern/default_string_traits.hpp>
+#include <intern/details/utils.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace intern {
+namespace details {
+
+// A string to sort next to 8 of its bytes, big endian and zero padded.
+// The strings travel with their keys so that ties are broken and the
+// result written back without going back to the input.
+template<typename StringT>
+struct sort_entry
+{
+    std::uint64_t key;
+    StringT s;
+};
+
+// Bytes [at, at + 8) of s as a key
+inline std::uint64_t sort_key(const char* s, std::size_t sz,
+        std::size_t at) noexcept
+{
+    std::uint64_t k = 0;
+    if(INTERN__LIKELY(sz >= at + sizeof(k)))
+    {
+        std::memcpy(&k, s + at, sizeof(k));
+        return __builtin_bswap64(k);
+    }
+    if(sz <= at)
+    {
+        return 0;
+    }
+    // 1 to 7 bytes by overlapping loads instead of a memcpy call
+    s += at;
+    const auto n = sz - at;
+    if(n >= 4)
+    {
+        std::uint32_t lo, hi;
+        std::memcpy(&lo, s, sizeof(lo));
+        std::memcpy(&hi, s + n - 4, sizeof(hi));
+        k = lo | std::uint64_t(hi) << (8 * (n - 4));
+    }
+    else
+    {
+        k = std::uint64_t(std::uint8_t(s[0]))
+            | std::uint64_t(std::uint8_t(s[n / 2])) << (8 * (n / 2))
+            | std::uint64_t(std::uint8_t(s[n - 1])) << (8 * (n - 1));
+    }
+    return __builtin_bswap64(k);
+}
+
+// The first key of a string. Small strings have at least 8 bytes of
+// inline buffer behind data(), read in one go and masked to their size.
+template<typename StringT>
+std::uint64_t first_sort_key(const StringT& s) noexcept
+{
+    if constexpr(StringT::sso_size + 1 >= sizeof(std::uint64_t))
+    {
+        if(s.small())
+        {
+            std::uint64_t k;
+            std::memcpy(&k, s.data(), sizeof(k));
+            const auto sz = s.size();
+            return sz >= sizeof(k)
+                ? __builtin_bswap64(k)
+                : __builtin_bswap64(k) & ~(~std::uint64_t(0) >> (8 * sz));
+        }
+    }
+    return sort_key(s.data(), s.size(), 0);
+}
+
+// Below this a bucket is sorted by comparisons
+constexpr std::size_t kRadixCutoff = 64;
+
+// a[0, n) still to be sorted on the bytes [at, at + 8) of the strings,
+// key byte `byte` onwards (byte 0 is the most significant). Each pass
+// moves the entries to the other one of a and buf; they end up in a if
+// home, else in buf.
+template<typename E>
+struct radix_task
+{
+    E* a;
+    E* buf;
+    std::size_t n;
+    int byte;
+    std::size_t at;
+    bool home;
+};
+
+// a[0, n) sorted where it is: copy it home if that is buf
+template<typename E>
+void radix_done(E* a, E* buf, std::size_t n, bool home)
+{
+    if(!home)
+    {
+        std::copy(a, a + n, buf);
+    }
+}
+
+// All of t share bytes [0, at + 8). Those no longer than that come first,
+// shortest first (the others only add zeros to them); what is left is
+// to be sorted on the next 8 bytes.
+template<typename E>
+radix_task<E> radix_next(const radix_task<E>& t)
+{
+    const auto at = t.at + 8;
+    const auto mid = std::partition(t.a, t.a + t.n, [at](const E& e)
+    {
+        return e.s.size() <= at;
+    });
+    const auto shorter = [](const E& x, const E& y)
+    {
+        return x.s.size() < y.s.size();
+    };
+    // Often all the same string
+    if(!std::is_sorted(t.a, mid, shorter))
+    {
+        std::sort(t.a, mid, shorter);
+    }
+    radix_done(t.a, t.buf, static_cast<std::size_t>(mid - t.a), t.home);
+    for(auto e = mid; e != t.a + t.n; ++e)
+    {
+        e->key = sort_key(e->s.data(), e->s.size(), at);
+    }
+    const auto rest = static_cast<std::size_t>(t.a + t.n - mid);
+    return {mid, t.buf + (mid - t.a), rest, 0, at, t.home};
+}
+
+// One step of the MSD radix sort of t: t is sorted, or what is left of it
+// goes to todo. Nothing recurses, so long shared prefixes or deep splits
+// only grow todo and not the stack.
+template<typename E>
+void radix_step(radix_task<E> t, std::vector<radix_task<E>>& todo)
+{
+    // Copies of one string share all their keys
+    if(t.n >= kRadixCutoff && std::all_of(t.a + 1, t.a + t.n,
+                [a = t.a](const E& e) { return e.key == a->key; }))
+    {
+        todo.push_back(radix_next(t));
+        return;
+    }
+    for(;; ++t.byte)
+    {
+        if(t.n < kRadixCutoff)
+        {
+            std::sort(t.a, t.a + t.n, [](const E& x, const E& y)
+            {
+                return x.key < y.key || (x.key == y.key && x.s < y.s);
+            });
+            radix_done(t.a, t.buf, t.n, t.home);
+            return;
+        }
+        if(t.byte == 8)
+        {
+            todo.push_back(radix_next(t));
+            return;
+        }
+        const auto shift = 56 - 8 * t.byte;
+        std::size_t count[256] = {};
+        for(std::size_t i = 0; i != t.n; ++i)
+        {
+            ++count[(t.a[i].key >> shift) & 0xFF];
+        }
+        // All in one bucket: go straight to the next byte
+        if(count[(t.a[0].key >> shift) & 0xFF] == t.n)
+        {
+            continue;
+        }
+        std::size_t to[256];
+        std::size_t sum = 0;
+        for(int b = 0; b != 256; ++b)
+        {
+            to[b] = sum;
+            sum += count[b];
+        }
+        for(std::size_t i = 0; i != t.n; ++i)
+        {
+            t.buf[to[(t.a[i].key >> shift) & 0xFF]++] = t.a[i];
+        }
+        std::size_t from = 0;
+        for(int b = 0; b != 256; from += count[b++])
+        {
+            if(count[b] != 0)
+            {
+                todo.push_back({t.buf + from, t.a + from, count[b],
+                        t.byte + 1, t.at, !t.home});
+            }
+        }
+        return;
+    }
+}
+
+template<typename E>
+void radix_sort(E* a, E* buf, std::size_t n, int byte, std::size_t at,
+        bool home)
+{
+    std::vector<radix_task<E>> todo{{a, buf, n, byte, at, home}};
+    while(!todo.empty())
+    {
+        const auto t = todo.back();
+        todo.pop_back();
+        radix_step(t, todo);
+    }
+}
+
+// The first byte split on the calling thread, then the buckets shared
+// out to `threads` workers, largest first
+template<typename E>
+void parallel_radix_sort(E* a, E* buf, std::size_t n, unsigned threads)
+{
+    std::size_t count[256] = {};
+    for(std::size_t i = 0; i != n; ++i)
+    {
+        ++count[a[i].key >> 56];
+    }
+    std::size_t to[256];
+    std::size_t sum = 0;
+    for(int b = 0; b != 256; ++b)
+    {
+        to[b] = sum;
+        sum += count[b];
+    }
+    for(std::size_t i = 0; i != n; ++i)
+    {
+        buf[to[a[i].key >> 56]++] = a[i];
+    }
+
+    std::vector<std::pair<std::size_t, std::size_t>> buckets;
+    std::size_t from = 0;
+    for(int b = 0; b != 256; from += count[b++])
+    {
+        if(count[b] != 0)
+        {
+            buckets.emplace_back(from, count[b]);
+        }
+    }
+    std::sort(buckets.begin(), buckets.end(), [](const auto& x, const auto& y)
+    {
+        return x.second > y.second;
+    });
+
+    std::atomic<std::size_t> next{0};
+    auto work = [&]
+    {
+        for(auto k = next++; k < buckets.size(); k = next++)
+        {
+            const auto& bk = buckets[k];
+            radix_sort(buf + bk.first, a + bk.first, bk.second, 1, 0, false);
+        }
+    };
+    std::vector<std::thread> pool;
+    for(unsigned t = 1; t < threads; ++t)
+    {
+        pool.emplace_back(work);
+    }
+    work();
+    for(auto& t : pool)
+    {
+        t.join();
+    }
+}
+
+}
+
+// Sorts a range of string_far, string_sso_tiny or string_sso_v1/2/3 in
+// the order of their compare(). The strings are radix
+// sorted 8 bytes at a time; only small buckets are sorted by comparisons.
+// With threads > 1, large inputs are sorted by that many threads.
+// String traits with their own cmp() fall back to std::sort.
+template<typename It>
+void sort(It first, It last, unsigned threads = 1)
+{
+    using StringT = typename std::iterator_traits<It>::value_type;
+    using Traits = typename StringT::traits_type;
+    constexpr std::size_t kParallelMin = std::size_t(1) << 16;
+
+    if constexpr(&Traits::cmp != &default_string_traits::cmp)
+    {
+        std::sort(first, last);
+    }
+    else
+    {
+        using entry = details::sort_entry<StringT>;
+        const auto n = static_cast<std::size_t>(std::distance(first, last));
+        if(n < 2)
+        {
+            return;
+        }
+        std::vector<entry> entries;
+        entries.reserve(n);
+        for(auto it = first; it != last; ++it)
+        {
+            const StringT& s = *it;
+            entries.push_back({details::first_sort_key(s), s});
+        }
+        std::vector<entry> buf(n, entries[0]);
+        if(threads > 1 && n >= kParallelMin)
+        {
+            details::parallel_radix_sort(entries.data(), buf.data(), n,
+                    threads);
+        }
+        else
+        {
+            details::radix_sort(entries.data(), buf.data(), n, 0, 0, true);
+        }
+        for(const auto& e : entries)
+        {
+            *first++ = e.s;
+        }
+    }
+}
+
+template<typename Range>
+void sort(Range& r, unsigned threads = 1)
+{
+    intern::sort(std::begin(r), std::end(r), threads);
+}
+
+}
@@ -24,6 +24,7 @@
 
 #include <intern/details/string_common.hpp>
 #include <intern/details/metadata.hpp>
+#include <intern/string_id.hpp>
 
 namespace intern
 {
@@ -58,10 +59,40 @@ public:
         swap(_data, o._data);
     }
 
-    constexpr size_type size() const noexcept { return _meta()._len; }
+    constexpr size_type size() const noexcept
+    {
+        return details::size_header<Traits>::read(_meta());
+    }
     constexpr const_pointer data() const noexcept { return _data; }
     constexpr bool small() const noexcept { return false; }
 
+    // Hash stored by the interner (requires Traits::metadata_store_hash)
+    constexpr std::size_t hash() const noexcept
+    {
+        static_assert(Traits::metadata_store_hash,
+                "the hash is not kept in the metadata");
+        return _meta()._hash;
+    }
+
+    // Position in byte order (requires Traits::metadata_store_rank). Only
+    // compare ranks of strings of the same interner; they change as
+    // strings are added, their order does not. compare() checks the rank
+    // space itself.
+    std::uint64_t rank() const noexcept
+    {
+        static_assert(Traits::metadata_store_rank,
+                "the rank is not kept in the metadata");
+        return _meta()._rank;
+    }
+
+    // Id given by the interner (requires Traits::metadata_store_id)
+    constexpr string_id id() const noexcept
+    {
+        static_assert(Traits::metadata_store_id,
+                "the id is not kept in the metadata");
+        return string_id{_meta()._id};
+    }
+
 private:
     using metadata = details::metadata<Traits>;
     constexpr const metadata& _meta() const noexcept
@@ -85,7 +116,7 @@ inline constexpr bool operator==(
     else
     {
         return a.size() == b.size() &&
-            !Traits::cmp(a.data(), b.data(), a.size());
+            details::traits_eq<Traits>(a.data(), b.data(), a.size());
     }
 }
 
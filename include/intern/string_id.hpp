@@ -0,0 +1,89 @@
+#pragma once
+
+// The MIT License (MIT)
+//
+// Copyright (c) 2019 jh0x
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <intern/details/metadata.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace intern
+{
+
+// Dense 32 bit handle of an interned string (Traits::metadata_store_id).
+// The interner numbers strings 0, 1, 2, ... in the order they are first
+// seen, so that side tables can be plain vectors indexed by value().
+// interner::far(string_id) and string_far::id() convert both ways in O(1).
+class string_id
+{
+public:
+    using value_type = std::uint32_t;
+
+    // Not the id of any string
+    constexpr string_id() noexcept = default;
+    constexpr explicit string_id(value_type v) noexcept : _value{v} {}
+
+    constexpr value_type value() const noexcept { return _value; }
+    constexpr bool valid() const noexcept { return _value != details::kNoId; }
+
+    friend constexpr std::size_t hash_value(string_id id) noexcept
+    {
+        return id._value;
+    }
+
+private:
+    value_type _value = details::kNoId;
+};
+
+inline constexpr bool operator==(string_id a, string_id b) noexcept
+{
+    return a.value() == b.value();
+}
+
+inline constexpr bool operator!=(string_id a, string_id b) noexcept
+{
+    return a.value() != b.value();
+}
+
+// Order of first interning
+inline constexpr bool operator<(string_id a, string_id b) noexcept
+{
+    return a.value() < b.value();
+}
+
+}
+
+namespace std
+{
+
+template<>
+struct hash<intern::string_id>
+{
+    std::size_t operator()(intern::string_id id) const noexcept
+    {
+        return id.value();
+    }
+};
+
+}
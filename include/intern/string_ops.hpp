@@ -38,7 +38,8 @@ constexpr bool operator==(
         const std::string_view& b
         ) noexcept
 {
-    return a.size() == b.size() && !Traits::cmp(a.data(), b.data(), a.size());
+    return a.size() == b.size()
+        && details::traits_eq<Traits>(a.data(), b.data(), a.size());
 }
 template<typename T, typename Traits>
 constexpr bool operator==(
@@ -46,7 +47,8 @@ constexpr bool operator==(
         const details::string_common<T, Traits>& b
         ) noexcept
 {
-    return a.size() == b.size() && !Traits::cmp(a.data(), b.data(), a.size());
+    return a.size() == b.size()
+        && details::traits_eq<Traits>(a.data(), b.data(), a.size());
 }
 #endif
 
@@ -56,7 +58,8 @@ constexpr bool operator==(
         const std::string& b
         ) noexcept
 {
-    return a.size() == b.size() && !Traits::cmp(a.data(), b.data(), a.size());
+    return a.size() == b.size()
+        && details::traits_eq<Traits>(a.data(), b.data(), a.size());
 }
 template<typename T, typename Traits>
 constexpr bool operator==(
@@ -64,7 +67,8 @@ constexpr bool operator==(
         const details::string_common<T, Traits>& b
         ) noexcept
 {
-    return a.size() == b.size() && !Traits::cmp(a.data(), b.data(), a.size());
+    return a.size() == b.size()
+        && details::traits_eq<Traits>(a.data(), b.data(), a.size());
 }
 
 }
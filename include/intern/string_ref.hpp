@@ -0,0 +1,102 @@
+#pragma once
+
+// The MIT License (MIT)
+//
+// Copyright (c) 2019 jh0x
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <utility>
+
+namespace intern
+{
+
+// Counted reference to a string of a reclaiming interner (see
+// interner::ref()). The string stays interned as long as a string_ref to
+// it exists; the last one going away removes it from the interner and
+// recycles its memory. get() hands out the plain string_far, which is
+// only valid while the string_ref is.
+template<typename Interner>
+class string_ref
+{
+public:
+    using stringF = typename Interner::stringF;
+
+    string_ref(const string_ref& o) noexcept
+        : _owner{o._owner}
+        , _s{o._s}
+    {
+        if(_owner)
+        {
+            _owner->_acquire(_s.data());
+        }
+    }
+    string_ref(string_ref&& o) noexcept
+        : _owner{std::exchange(o._owner, nullptr)}
+        , _s{o._s}
+    {}
+    string_ref& operator=(string_ref o) noexcept
+    {
+        swap(o);
+        return *this;
+    }
+    ~string_ref()
+    {
+        if(_owner)
+        {
+            _owner->_release(_s.data());
+        }
+    }
+
+    void swap(string_ref& o) noexcept
+    {
+        using std::swap;
+        swap(_owner, o._owner);
+        swap(_s, o._s);
+    }
+
+    const stringF& get() const noexcept { return _s; }
+    operator const stringF&() const noexcept { return _s; }
+    const char* data() const noexcept { return _s.data(); }
+    auto size() const noexcept { return _s.size(); }
+
+    friend bool operator==(const string_ref& a, const string_ref& b) noexcept
+    {
+        return a._s == b._s;
+    }
+    friend bool operator!=(const string_ref& a, const string_ref& b) noexcept
+    {
+        return !(a == b);
+    }
+
+private:
+    friend Interner;
+    string_ref(Interner* owner, stringF s) noexcept : _owner{owner}, _s{s} {}
+
+    Interner* _owner;
+    stringF _s;
+};
+
+template<typename Interner>
+void swap(string_ref<Interner>& a, string_ref<Interner>& b) noexcept
+{
+    a.swap(b);
+}
+
+}
@@ -22,12 +22,22 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#include <intern/details/hash.hpp>
 #include <intern/details/string_common.hpp>
 #include <intern/details/utils.hpp>
+#include <intern/default_string_traits.hpp>
 #include <intern/string_far.hpp>
 
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+
 namespace intern {
 
+namespace details {
+template<typename> struct interned_key;
+}
+
 template<typename Traits>
 class string_sso_tiny
     : public details::string_common<
@@ -49,6 +59,9 @@ public:
     using typename BaseT::const_reverse_iterator;
     using typename BaseT::size_type;
     template<typename, typename> friend class interner;
+    template<typename> friend class scoped_interner;
+    template<typename> friend class interned_column;
+    template<typename> friend struct details::interned_key;
 
     constexpr static auto raw_size = sizeof(char*);
     constexpr static auto sso_size = raw_size - 1;
@@ -81,14 +94,75 @@ public:
             : far().data();
     }
 
-    template<std::size_t N>
-    constexpr bool operator==(const string_sso_tiny<Traits>& o) const
+    // Small strings hash their few bytes, far ones return the hash stored
+    // by the interner (requires Traits::metadata_store_hash). Same values as
+    // details::hash_small(), straight from the word.
+    constexpr std::size_t hash() const noexcept
+    {
+        return INTERN__LIKELY(small())
+            ? details::mix64((_uint & kCharsMask)
+                    ^ (size() * 0x9e3779b97f4a7c15ULL))
+            : far().hash();
+    }
+
+    // Whole word comparisons, when the traits compare plain bytes: small
+    // strings keep their unused bytes zeroed, far ones are a pointer.
+    friend constexpr bool operator==(string_sso_tiny a, string_sso_tiny b)
+        noexcept
+    {
+        if constexpr(word_eq && Traits::string_far_use_ptr_equality)
+        {
+            return a._uint == b._uint;
+        }
+        else if constexpr(word_eq)
+        {
+            // A small string never equals a far one (they are longer)
+            return a._uint == b._uint
+                || (!a.small() && !b.small() && a.far() == b.far());
+        }
+        else
+        {
+            return a.size() == b.size()
+                && details::traits_eq<Traits>(a.data(), b.data(), a.size());
+        }
+    }
+    friend constexpr bool operator!=(string_sso_tiny a, string_sso_tiny b)
+        noexcept
+    {
+        return !(a == b);
+    }
+    friend constexpr bool operator<(string_sso_tiny a, string_sso_tiny b)
+        noexcept
+    {
+        return a._compare(b) < 0;
+    }
+    friend constexpr bool operator<=(string_sso_tiny a, string_sso_tiny b)
+        noexcept
+    {
+        return a._compare(b) <= 0;
+    }
+    friend constexpr bool operator>(string_sso_tiny a, string_sso_tiny b)
+        noexcept
     {
-        return size() == o.size() && !Traits::cmp(data(), o.data(), size());
+        return a._compare(b) > 0;
+    }
+    friend constexpr bool operator>=(string_sso_tiny a, string_sso_tiny b)
+        noexcept
+    {
+        return a._compare(b) >= 0;
     }
 
 private:
-    constexpr string_sso_tiny(const char* s, size_type sz)
+    // Only with the byte-wise cmp() / eq() of default_string_traits
+    constexpr static bool word_eq = !details::eq_from_cmp<Traits>()
+        && &Traits::eq == &default_string_traits::eq;
+    constexpr static bool word_cmp =
+        &Traits::cmp == &default_string_traits::cmp;
+    // The characters of a small string (the last byte is its size)
+    constexpr static std::uintptr_t kCharsMask =
+        ~std::uintptr_t(0) >> CHAR_BIT;
+
+    constexpr string_sso_tiny(const char* s, size_type sz) : _uint{0}
     {
         INTERN__ASSUME(sz <= sso_size);
         Traits::copy(_raw, s, sz);
@@ -114,6 +188,22 @@ private:
         return sizeof(x) == 8 ? __builtin_bswap64(x) : __builtin_bswap32(x);
     }
 
+    // Two small strings in byte order: the characters big endian first,
+    // then the size (stored as sso_size - size, hence flipped)
+    constexpr int _compare(string_sso_tiny o) const noexcept
+    {
+        if constexpr(word_cmp)
+        {
+            if(INTERN__LIKELY(small() && o.small()))
+            {
+                const auto a = massage(_uint) ^ 0xFF;
+                const auto b = massage(o._uint) ^ 0xFF;
+                return a == b ? 0 : a < b ? -1 : 1;
+            }
+        }
+        return this->compare(o);
+    }
+
     union
     {
         char _raw[raw_size];
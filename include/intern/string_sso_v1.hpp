@@ -22,7 +22,9 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#include <intern/details/hash.hpp>
 #include <intern/details/string_common.hpp>
+#include <intern/string_far.hpp>
 
 namespace intern {
 
@@ -45,6 +47,8 @@ public:
     using typename BaseT::const_reverse_iterator;
     using typename BaseT::size_type;
     template<typename, typename> friend class interner;
+    template<typename> friend class scoped_interner;
+    template<typename> friend class interned_column;
 
     constexpr static auto _min_sso_size = 16;
     static_assert(S >= _min_sso_size, "size too small");
@@ -77,10 +81,20 @@ public:
         return small() ? _s._data : _b._data;
     }
 
+    // Small strings hash their few bytes, far ones return the hash stored
+    // by the interner (requires Traits::metadata_store_hash)
+    constexpr std::size_t hash() const noexcept
+    {
+        return INTERN__LIKELY(small())
+            ? details::hash_small(_s._data, size())
+            : string_far<Traits>{_b._data}.hash();
+    }
+
     template<std::size_t N>
     constexpr bool operator==(const string_sso_v1<N, Traits>& o) const
     {
-        return size() == o.size() && !Traits::cmp(data(), o.data(), size());
+        return size() == o.size()
+            && details::traits_eq<Traits>(data(), o.data(), size());
     }
 
 private:
@@ -0,0 +1,89 @@
+#pragma once
+
+// The MIT License (MIT)
+//
+// Copyright (c) 2019 jh0x
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace intern
+{
+
+// How much a suffix-sharing arena would save on a set of strings.
+//
+// The interner cannot share bytes between "USD" and "EURUSD": a string_far
+// finds its length (and hash, id) right in front of its first character,
+// where the shorter string would need its own metadata while the longer
+// one has "EUR". This measures what tail merging would give if the
+// metadata moved out of line, so that the trade-off can be judged on a
+// real corpus.
+struct suffix_stats
+{
+    std::size_t strings = 0;        // distinct strings
+    std::size_t bytes = 0;          // their characters, NULs included
+    std::size_t suffixes = 0;       // strings that are a suffix of another
+    std::size_t shared_bytes = 0;   // bytes those would not need
+};
+
+// Range of distinct strings (anything with data() and size())
+template<typename It>
+suffix_stats suffix_report(It first, It last)
+{
+    std::vector<std::string> reversed;
+    for(; first != last; ++first)
+    {
+        const auto* d = first->data();
+        reversed.emplace_back(std::make_reverse_iterator(d + first->size()),
+                std::make_reverse_iterator(d));
+    }
+    std::sort(reversed.begin(), reversed.end());
+    reversed.erase(std::unique(reversed.begin(), reversed.end()),
+            reversed.end());
+
+    // A suffix of some string is a prefix of the reversed string right
+    // after it once they are sorted
+    suffix_stats st;
+    st.strings = reversed.size();
+    for(std::size_t k = 0; k != reversed.size(); ++k)
+    {
+        const auto& r = reversed[k];
+        st.bytes += r.size() + 1;
+        if(k + 1 != reversed.size()
+                && reversed[k + 1].compare(0, r.size(), r) == 0)
+        {
+            ++st.suffixes;
+            st.shared_bytes += r.size() + 1;
+        }
+    }
+    return st;
+}
+
+template<typename Range>
+suffix_stats suffix_report(const Range& r)
+{
+    return suffix_report(std::begin(r), std::end(r));
+}
+
+}
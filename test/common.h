@@ -39,7 +39,14 @@ namespace intern
 template<typename T, typename Traits>
 std::size_t hash_value(const intern::details::string_common<T, Traits>& s)
 {
-    return hash_sv{}(s.data(), s.size());
+    if constexpr(Traits::metadata_store_hash)
+    {
+        return static_cast<const T&>(s).hash();
+    }
+    else
+    {
+        return hash_sv{}(s.data(), s.size());
+    }
 }
 }
 
@@ -116,3 +123,72 @@ struct interner_traits2
     }
 };
 
+// Same as interner_traits1 but with the compact index
+struct interner_traits3
+{
+    constexpr static auto compact_index = true;
+    using hasherT = hash_sv;
+
+    static void* allocate(std::size_t s, std::size_t a)
+        noexcept(noexcept(intern::_bad_alloc()))
+    {
+        _off() = ((_off() + (a - 1)) & -a);
+        void* ptr = _buf() + _off();
+        _off() += s;
+        if(_off() > kBufferSize)
+        {
+            intern::_bad_alloc();
+        }
+        return ptr;
+    }
+    static std::uint32_t offset(const char* p) noexcept
+    {
+        return static_cast<std::uint32_t>(p - _buf());
+    }
+    static const char* address(std::uint32_t o) noexcept
+    {
+        return _buf() + o;
+    }
+    static void raze() noexcept
+    {
+        std::memset(_buf(), '\0', kBufferSize);
+        _off() = 0;
+    }
+    static char* _buf() noexcept
+    {
+        alignas(8) static char buf[kBufferSize]{};
+        return buf;
+    }
+    static std::size_t& _off() noexcept
+    {
+        static std::size_t off;
+        return off;
+    }
+};
+
+// Growable arena owned by each interner; a tiny first chunk so that the
+// tests go through many chunks
+struct interner_traits4
+{
+    using hasherT = hash_sv;
+    template<typename K, typename V>
+    using lookupT = phmap::parallel_flat_hash_map<K, V>;
+
+    struct allocatorT : intern::arena
+    {
+        allocatorT() noexcept : intern::arena{256} {}
+    };
+    static void raze() noexcept {}
+};
+
+// Same with the compact index
+struct interner_traits5 : interner_traits4
+{
+    constexpr static auto compact_index = true;
+};
+
+// Strings interned through ref() are dropped with their last string_ref
+struct interner_traits6 : interner_traits4
+{
+    constexpr static auto reclaim = true;
+};
@@ -0,0 +1,419 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2019 jh0x
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Reads a corpus, one string per line (or per delimiter), and tells which
+// string representation suits it: the lengths and duplicates in it and,
+// for every representation, the memory it takes and how fast it interns
+// and compares. Rows too long for the interner's size_type are skipped
+// (and counted) rather than truncated.
+//
+//   intern_analyze [-d <delimiter>] [file|-]     (default test/words.txt)
+
+#include <intern/interner.hpp>
+#include <intern/interner_demo_traits.hpp>
+#include <intern/string_ops.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace x = intern;
+
+namespace
+{
+
+// Every interner owns an arena, so that each representation starts empty
+// and stats() tells the arena and index bytes it needed
+struct analyze_traits : x::interner_sample_arena_traits<>
+{
+    constexpr static auto statistics = true;
+};
+using interner_t = x::interner<analyze_traits>;
+
+// At least that many operations per timing, best of kRuns
+constexpr std::size_t kMinOps = 1 << 21;
+constexpr int kRuns = 5;
+
+struct result
+{
+    std::string name;
+    std::size_t handle_bytes;
+    std::size_t sso_size;
+    double inline_ratio;
+    std::size_t arena_bytes;
+    std::size_t index_bytes;
+    double bytes_per_row;
+    double intern_ns;
+    double eq_ns;
+    double less_ns;
+
+    double ns() const noexcept { return intern_ns + eq_ns + less_ns; }
+};
+
+// Longest row the interners can take (their size_type)
+constexpr std::size_t kMaxRow =
+    std::numeric_limits<interner_t::StringTraits::size_type>::max();
+
+// Rows longer than kMaxRow would be truncated: they are left out and
+// counted in skipped
+std::vector<std::string> read_corpus(std::istream& in, char delimiter,
+        std::size_t& skipped)
+{
+    std::vector<std::string> rows;
+    std::string s;
+    while(std::getline(in, s, delimiter))
+    {
+        if(delimiter == '\n' && !s.empty() && s.back() == '\r')
+        {
+            s.pop_back();
+        }
+        if(s.size() > kMaxRow)
+        {
+            ++skipped;
+            continue;
+        }
+        rows.push_back(s);
+    }
+    return rows;
+}
+
+// Best time per operation of f(), which does ops operations
+template<typename F>
+double time_ns(std::size_t ops, F&& f)
+{
+    double best = 0;
+    for(int run = 0; run != kRuns; ++run)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        f();
+        const std::chrono::duration<double, std::nano> d =
+            std::chrono::steady_clock::now() - start;
+        const auto ns = d.count() / double(ops);
+        best = run == 0 ? ns : std::min(best, ns);
+    }
+    return best;
+}
+
+std::size_t rounds(std::size_t rows)
+{
+    return std::max<std::size_t>(1, kMinOps / std::max<std::size_t>(rows, 1));
+}
+
+template<typename T>
+void keep(const T& v)
+{
+    asm volatile("" : : "r,m"(v) : "memory");
+}
+
+template<typename StringT, typename Make>
+result analyze(const std::string& name, const std::vector<std::string>& rows,
+        const std::vector<std::size_t>& pairs, Make make)
+{
+    result r{};
+    r.name = name;
+    r.handle_bytes = sizeof(StringT);
+    r.sso_size = StringT::sso_size;
+
+    interner_t i;
+    std::vector<StringT> values;
+    values.reserve(rows.size());
+    for(const auto& s : rows)
+    {
+        values.push_back(make(i, s));
+    }
+    const auto st = i.stats();
+    const auto small = std::count_if(values.begin(), values.end(),
+            [](const StringT& v) { return v.small(); });
+    const auto n = std::max<std::size_t>(rows.size(), 1);
+    r.inline_ratio = double(small) / double(n);
+    r.arena_bytes = st.arena_used;
+    r.index_bytes = st.index_bytes;
+    r.bytes_per_row = double(sizeof(StringT))
+        + double(st.arena_used + st.index_bytes) / double(n);
+
+    // A new interner per round: duplicates hit, first occurrences miss
+    const auto m = rounds(values.size());
+    r.intern_ns = time_ns(m * rows.size(), [&]
+    {
+        std::vector<StringT> out;
+        out.reserve(rows.size());
+        for(std::size_t k = 0; k != m; ++k)
+        {
+            interner_t fresh;
+            out.clear();
+            for(const auto& s : rows)
+            {
+                out.push_back(make(fresh, s));
+            }
+            keep(out.data());
+        }
+    });
+
+    r.eq_ns = time_ns(m * values.size(), [&]
+    {
+        std::size_t c = 0;
+        for(std::size_t k = 0; k != m; ++k)
+        {
+            for(std::size_t j = 0; j != values.size(); ++j)
+            {
+                c += values[j] == values[pairs[j]];
+            }
+            keep(c);
+        }
+    });
+    r.less_ns = time_ns(m * values.size(), [&]
+    {
+        std::size_t c = 0;
+        for(std::size_t k = 0; k != m; ++k)
+        {
+            for(std::size_t j = 0; j != values.size(); ++j)
+            {
+                c += values[j] < values[pairs[j]];
+            }
+            keep(c);
+        }
+    });
+    return r;
+}
+
+std::string bucket_name(std::size_t k)
+{
+    if(k == 0)
+    {
+        return "0";
+    }
+    const auto lo = std::size_t(1) << (k - 1);
+    if(k == x::details::kLengthBuckets - 1)
+    {
+        return std::to_string(lo) + "+";
+    }
+    const auto hi = (std::size_t(1) << k) - 1;
+    return lo == hi ? std::to_string(lo)
+        : std::to_string(lo) + "-" + std::to_string(hi);
+}
+
+void report_corpus(const std::vector<std::string>& rows, std::ostream& o)
+{
+    std::unordered_set<std::string> distinct(rows.begin(), rows.end());
+    std::vector<std::size_t> lengths;
+    lengths.reserve(rows.size());
+    std::size_t bytes = 0;
+    std::size_t histogram[x::details::kLengthBuckets] = {};
+    for(const auto& s : rows)
+    {
+        lengths.push_back(s.size());
+        bytes += s.size();
+        ++histogram[x::details::length_bucket(s.size())];
+    }
+    std::sort(lengths.begin(), lengths.end());
+    const auto at = [&lengths](double q)
+    {
+        return lengths[std::size_t(q * double(lengths.size() - 1))];
+    };
+
+    o << std::fixed << std::setprecision(2);
+    o << "rows " << rows.size() << ", distinct " << distinct.size()
+      << ", duplication " << double(rows.size()) / double(distinct.size())
+      << "x, " << bytes << " bytes\n";
+    o << "length min " << lengths.front() << ", median " << at(0.5)
+      << ", p90 " << at(0.9) << ", p99 " << at(0.99)
+      << ", max " << lengths.back()
+      << ", mean " << double(bytes) / double(rows.size()) << "\n\n";
+
+    for(std::size_t k = 0; k != x::details::kLengthBuckets; ++k)
+    {
+        if(!histogram[k])
+        {
+            continue;
+        }
+        const auto share = double(histogram[k]) / double(rows.size());
+        o << std::setw(8) << bucket_name(k) << std::setw(10) << histogram[k]
+          << std::setw(8) << 100 * share << "% "
+          << std::string(std::size_t(share * 50 + 0.5), '#') << '\n';
+    }
+    o << '\n';
+}
+
+void report_results(const std::vector<result>& results, std::ostream& o)
+{
+    o << std::left << std::setw(10) << "type" << std::right
+      << std::setw(7) << "sizeof" << std::setw(6) << "sso"
+      << std::setw(9) << "inline" << std::setw(11) << "arena B"
+      << std::setw(11) << "index B" << std::setw(10) << "B/row"
+      << std::setw(11) << "intern ns" << std::setw(8) << "eq ns"
+      << std::setw(9) << "less ns" << '\n';
+    for(const auto& r : results)
+    {
+        o << std::left << std::setw(10) << r.name << std::right
+          << std::setw(7) << r.handle_bytes << std::setw(6) << r.sso_size
+          << std::setw(8) << 100 * r.inline_ratio << '%'
+          << std::setw(11) << r.arena_bytes << std::setw(11) << r.index_bytes
+          << std::setw(10) << r.bytes_per_row << std::setw(11) << r.intern_ns
+          << std::setw(8) << r.eq_ns << std::setw(9) << r.less_ns << '\n';
+    }
+    o << '\n';
+}
+
+// The smallest footprint among the representations that are at most kSlack
+// times slower than the fastest one (intern + eq + less)
+constexpr double kSlack = 1.5;
+
+void recommend(const std::vector<result>& results, std::ostream& o)
+{
+    const auto by_bytes = [](const result& a, const result& b)
+    {
+        return a.bytes_per_row < b.bytes_per_row;
+    };
+    const auto by_ns = [](const result& a, const result& b)
+    {
+        return a.ns() < b.ns();
+    };
+    const auto& smallest = *std::min_element(
+            results.begin(), results.end(), by_bytes);
+    const auto& fastest = *std::min_element(
+            results.begin(), results.end(), by_ns);
+    const result* best = nullptr;
+    for(const auto& r : results)
+    {
+        if(r.ns() <= fastest.ns() * kSlack && (!best || by_bytes(r, *best)))
+        {
+            best = &r;
+        }
+    }
+
+    o << "smallest:    " << smallest.name << " (" << smallest.bytes_per_row
+      << " B/row, " << smallest.ns() << " ns)\n";
+    o << "fastest:     " << fastest.name << " (" << fastest.bytes_per_row
+      << " B/row, " << fastest.ns() << " ns)\n";
+    o << "recommended: " << best->name << " (" << best->bytes_per_row
+      << " B/row, " << best->ns() << " ns, "
+      << 100 * best->inline_ratio << "% inline)\n";
+}
+
+int usage(const char* self)
+{
+    std::cerr << "usage: " << self << " [-d <delimiter>] [file|-]\n"
+        "  -d  one character or \\t, \\n, \\0 (default \\n)\n";
+    return 2;
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    char delimiter = '\n';
+    std::string path = "test/words.txt";
+    for(int a = 1; a < argc; ++a)
+    {
+        const std::string arg = argv[a];
+        if(arg == "-d" && a + 1 < argc)
+        {
+            const std::string d = argv[++a];
+            if(d == "\\t") delimiter = '\t';
+            else if(d == "\\n") delimiter = '\n';
+            else if(d == "\\0") delimiter = '\0';
+            else if(d.size() == 1) delimiter = d[0];
+            else return usage(argv[0]);
+        }
+        else if(arg == "-h" || arg == "--help" || (arg[0] == '-' && arg != "-"))
+        {
+            return usage(argv[0]);
+        }
+        else
+        {
+            path = arg;
+        }
+    }
+
+    std::vector<std::string> rows;
+    std::size_t skipped = 0;
+    if(path == "-")
+    {
+        rows = read_corpus(std::cin, delimiter, skipped);
+    }
+    else
+    {
+        std::ifstream f(path, std::fstream::in | std::fstream::binary);
+        if(!f)
+        {
+            std::cerr << "cannot open " << path << '\n';
+            return 1;
+        }
+        rows = read_corpus(f, delimiter, skipped);
+    }
+    if(skipped)
+    {
+        std::cerr << "skipped " << skipped << " rows longer than " << kMaxRow
+            << " bytes\n";
+    }
+    if(rows.empty())
+    {
+        std::cerr << "no strings in " << path << '\n';
+        return 1;
+    }
+
+    std::cout << "corpus: " << path << '\n';
+    report_corpus(rows, std::cout);
+
+    // Random pairs for the comparisons, duplicates included
+    std::vector<std::size_t> pairs(rows.size());
+    std::uint64_t seed = 7;
+    for(auto& p : pairs)
+    {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        p = (seed >> 17) % rows.size();
+    }
+
+    std::vector<result> results;
+    results.push_back(analyze<interner_t::stringF>("far", rows, pairs,
+            [](interner_t& i, const std::string& s) { return i.far(s); }));
+    results.push_back(analyze<interner_t::stringST>("tiny", rows, pairs,
+            [](interner_t& i, const std::string& s) { return i.tiny(s); }));
+    results.push_back(analyze<interner_t::stringS1<16>>("sso1<16>", rows, pairs,
+            [](interner_t& i, const std::string& s) { return i.sso1<16>(s); }));
+    results.push_back(analyze<interner_t::stringS1<24>>("sso1<24>", rows, pairs,
+            [](interner_t& i, const std::string& s) { return i.sso1<24>(s); }));
+    results.push_back(analyze<interner_t::stringS1<32>>("sso1<32>", rows, pairs,
+            [](interner_t& i, const std::string& s) { return i.sso1<32>(s); }));
+    results.push_back(analyze<interner_t::stringS2<16>>("sso2<16>", rows, pairs,
+            [](interner_t& i, const std::string& s) { return i.sso2<16>(s); }));
+    results.push_back(analyze<interner_t::stringS2<24>>("sso2<24>", rows, pairs,
+            [](interner_t& i, const std::string& s) { return i.sso2<24>(s); }));
+    results.push_back(analyze<interner_t::stringS2<32>>("sso2<32>", rows, pairs,
+            [](interner_t& i, const std::string& s) { return i.sso2<32>(s); }));
+    results.push_back(analyze<interner_t::stringS3<24>>("sso3<24>", rows, pairs,
+            [](interner_t& i, const std::string& s) { return i.sso3<24>(s); }));
+    results.push_back(analyze<interner_t::stringS3<32>>("sso3<32>", rows, pairs,
+            [](interner_t& i, const std::string& s) { return i.sso3<32>(s); }));
+
+    report_results(results, std::cout);
+    recommend(results, std::cout);
+    return 0;
+}
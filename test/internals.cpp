@@ -181,6 +181,7 @@ int main()
     print([&i]{return i.tiny("0123456");});
     print([&i]{return i.sso1<16>("0123456789ABCDE");});
     print([&i]{return i.sso2<16>("01234");});
+    print([&i]{return i.sso3<16>("01234");});
 
     constexpr static auto txt =
         "This is a very very long string. "
@@ -191,6 +192,7 @@ int main()
     print([&]{return i.tiny(txt);});
     print([&]{return i.sso1<16>(txt);});
     print([&]{return i.sso2<24>(txt);});
+    print([&]{return i.sso3<24>(txt);});
 
 //    char data[] = "QWERTYUIOP";
 //    std::cout << (void*) data << std::endl;
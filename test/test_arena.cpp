@@ -0,0 +1,130 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2019 jh0x
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "test_interner.h"
+
+#include <intern/arena.hpp>
+
+#define TEST_IT_ARENA(traits)                                     \
+TYPE_TO_STRING(test_far_string<interner_traits4, traits>);        \
+TYPE_TO_STRING(test_sso_tiny<interner_traits4, traits>);          \
+TYPE_TO_STRING(test_sso_v1_string<interner_traits4, 16, traits>); \
+TYPE_TO_STRING(test_sso_v2_string<interner_traits4, 24, traits>); \
+TYPE_TO_STRING(test_far_string<interner_traits5, traits>);        \
+TYPE_TO_STRING(test_sso_v2_string<interner_traits5, 24, traits>); \
+TEST_CASE_TEMPLATE_INVOKE(                                        \
+        test_id                                                   \
+        , test_far_string<interner_traits4, traits>               \
+        , test_sso_tiny<interner_traits4, traits>                 \
+        , test_sso_v1_string<interner_traits4, 16, traits>        \
+        , test_sso_v2_string<interner_traits4, 24, traits>        \
+        , test_far_string<interner_traits5, traits>               \
+        , test_sso_v2_string<interner_traits5, 24, traits>        \
+        );
+
+TEST_IT_ARENA(Default);
+TEST_IT_ARENA(DefaultHash);
+
+TEST_CASE("arena pointers and offsets")
+{
+    x::arena a{64};
+    std::vector<std::pair<char*, std::size_t>> blocks;
+    for(std::size_t n = 1; n != 2000; ++n)
+    {
+        const auto sz = n % 97 + 1;
+        auto* p = static_cast<char*>(a.allocate(sz, n % 2 ? 1 : 8));
+        REQUIRE(p);
+        if(n % 2 == 0)
+        {
+            REQUIRE(reinterpret_cast<std::uintptr_t>(p) % 8 == 0);
+        }
+        std::memset(p, static_cast<int>(n & 0xFF), sz);
+        blocks.emplace_back(p, n);
+    }
+    // Bigger than any chunk so far
+    auto* big = static_cast<char*>(a.allocate(1 << 20, 8));
+    std::memset(big, 0xAB, 1 << 20);
+    REQUIRE(a.address(a.offset(big)) == big);
+    REQUIRE(a.address(a.offset(big + (1 << 20) - 1)) == big + (1 << 20) - 1);
+
+    for(auto& [p, n] : blocks)
+    {
+        // Still there after all the growth
+        REQUIRE(static_cast<unsigned char>(*p) == (n & 0xFF));
+        REQUIRE(a.address(a.offset(p)) == p);
+    }
+    REQUIRE(a.used() >= (1 << 20));
+    REQUIRE(a.reserved() >= a.used());
+
+    x::arena b{std::move(a)};
+    REQUIRE(a.reserved() == 0);
+    REQUIRE(b.address(b.offset(big)) == big);
+}
+
+TEST_CASE("arena offsets fit in 32 bits")
+{
+    x::arena a{64 << 10};
+    auto* p = static_cast<char*>(a.allocate(100, 8));
+    // Needs a chunk whose offsets would end past 4GB: nothing is mapped
+    REQUIRE_THROWS_AS(a.allocate(std::size_t(1) << 31, 8), std::bad_alloc);
+    REQUIRE(a.reserved() == (64 << 10));
+    // Still usable and the offsets are unchanged
+    auto* q = static_cast<char*>(a.allocate(100, 8));
+    REQUIRE(q == p + 104);
+    REQUIRE(a.address(a.offset(p)) == p);
+    REQUIRE(a.address(a.offset(q)) == q);
+}
+
+TEST_CASE("arena huge pages")
+{
+    for(auto pages : {x::arena_pages::transparent_huge,
+                      x::arena_pages::explicit_huge})
+    {
+        x::arena a{4096, pages};
+        auto* p = static_cast<char*>(a.allocate(100, 8));
+        std::memset(p, 1, 100);
+        REQUIRE(a.reserved() % x::arena::kHugePage == 0);
+        REQUIRE(a.used() == 100);
+        REQUIRE(a.address(a.offset(p)) == p);
+    }
+}
+
+TEST_CASE("interners with their own arena")
+{
+    x::interner<interner_traits4> a, b;
+    for(auto& s : words)
+    {
+        REQUIRE(a.far(s) == s);
+    }
+    REQUIRE(b.allocator().used() == 0);
+    for(auto& s : words)
+    {
+        REQUIRE(b.far(s) == s);
+        // Same contents, different storage
+        REQUIRE(a.far(s).data() != b.far(s).data());
+    }
+    REQUIRE(a.allocator().used() == b.allocator().used());
+    REQUIRE(a.allocator().reserved() >= a.allocator().used());
+
+    x::interner<x::interner_sample_arena_traits<>> c;
+    REQUIRE(c.far("SPY").data() == c.far(std::string("SPY")).data());
+}
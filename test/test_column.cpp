@@ -0,0 +1,102 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2019 jh0x
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "test_interner.h"
+#include <intern/interned_column.hpp>
+
+#include <set>
+
+namespace
+{
+
+template<typename Intern>
+void check_column(Intern intern)
+{
+    using StringT = decltype(intern(std::string{}));
+    std::vector<StringT> rows;
+    for(auto& s : words)
+    {
+        rows.push_back(intern(s));
+    }
+    const x::interned_column<StringT> col(rows.begin(), rows.end());
+    REQUIRE(col.size() == rows.size());
+    REQUIRE(col.small_count() + col.far_count() == rows.size());
+    for(std::size_t r = 0; r != rows.size(); ++r)
+    {
+        REQUIRE(col.small(r) == rows[r].small());
+        REQUIRE(std::string(col[r].data(), col[r].size()) == words[r]);
+    }
+
+    REQUIRE(col.count_distinct()
+            == std::set<std::string>(words.begin(), words.end()).size());
+
+    for(std::size_t n = 0; n != 40; ++n)
+    {
+        const auto& needle = words[n * 97 % words.size()];
+        const auto bits = col.find_equal(intern(needle));
+        REQUIRE(bits.size() == (rows.size() + 63) / 64);
+        std::size_t hits = 0;
+        for(std::size_t r = 0; r != rows.size(); ++r)
+        {
+            const bool hit = bits[r / 64] >> (r % 64) & 1;
+            REQUIRE(hit == (words[r] == needle));
+            hits += hit;
+        }
+        REQUIRE(col.count_equal(intern(needle)) == hits);
+    }
+    REQUIRE(col.count_equal(intern("not in there")) == 0);
+
+    std::vector<std::size_t> picks;
+    for(std::size_t r = rows.size(); r-- > 0; r /= 2)
+    {
+        picks.push_back(r);
+    }
+    std::vector<StringT> out;
+    col.prefetch(0, col.size());
+    col.materialize(picks.begin(), picks.end(), std::back_inserter(out));
+    REQUIRE(out.size() == picks.size());
+    for(std::size_t k = 0; k != picks.size(); ++k)
+    {
+        REQUIRE(out[k] == rows[picks[k]]);
+    }
+}
+
+}
+
+TEST_CASE("interned_column matches the rows it was built from")
+{
+    x::interner<interner_traits4> i;
+    for_each_string_type(i, [](auto intern) { check_column(intern); });
+}
+
+TEST_CASE("interned_column of a single small row")
+{
+    x::interner<interner_traits4> i;
+    x::interned_column<x::string_sso_v1<16, Default>> col;
+    REQUIRE(col.empty());
+    col.push_back(i.sso1<16>("abc"));
+    REQUIRE(col.find_equal(i.sso1<16>("abc")) == std::vector<std::uint64_t>{1});
+    REQUIRE(col.find_equal(i.sso1<16>("abd")) == std::vector<std::uint64_t>{0});
+    col.clear();
+    REQUIRE(col.empty());
+    REQUIRE(col.count_distinct() == 0);
+}
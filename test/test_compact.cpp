@@ -0,0 +1,62 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2019 jh0x
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "test_interner.h"
+
+#define TEST_IT_COMPACT(traits)                                   \
+TYPE_TO_STRING(test_far_string<interner_traits3, traits>);        \
+TYPE_TO_STRING(test_sso_tiny<interner_traits3, traits>);          \
+TYPE_TO_STRING(test_sso_v1_string<interner_traits3, 16, traits>); \
+TYPE_TO_STRING(test_sso_v2_string<interner_traits3, 24, traits>); \
+TEST_CASE_TEMPLATE_INVOKE(                                        \
+        test_id                                                   \
+        , test_far_string<interner_traits3, traits>               \
+        , test_sso_tiny<interner_traits3, traits>                 \
+        , test_sso_v1_string<interner_traits3, 16, traits>        \
+        , test_sso_v2_string<interner_traits3, 24, traits>        \
+        );
+
+TEST_IT_COMPACT(Default);
+TEST_IT_COMPACT(DefaultHash);
+
+TEST_CASE("compact index is compact")
+{
+    interner_traits1::raze();
+    interner_traits3::raze();
+    x::interner<interner_traits1> normal;
+    x::interner<interner_traits3> compact;
+    for(auto& s : words)
+    {
+        REQUIRE(normal.far(s) == s);
+        REQUIRE(compact.far(s) == s);
+    }
+    REQUIRE(normal.size() == compact.size());
+
+    const auto frozen = compact.freeze();
+    for(auto& s : words)
+    {
+        REQUIRE(frozen.find(s)->data() == compact.far(s).data());
+    }
+
+    // 1 tag byte + 4 offset bytes per slot
+    REQUIRE(compact.index_bytes() * 3 < normal.index_bytes());
+}
@@ -0,0 +1,77 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2019 jh0x
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "test_interner.h"
+
+#include <algorithm>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <intern/string_ops.hpp>
+
+///////////////////////////////////////////////////////////////////////
+
+TEST_CASE("concurrent interner")
+{
+    using interner_traits = x::interner_sample_concurrent_traits<(1 << 20)>;
+    x::interner<interner_traits> i;
+
+    constexpr std::size_t kThreads = 8;
+    std::vector<std::vector<const char*>> seen(kThreads);
+    std::vector<std::thread> threads;
+    for(std::size_t t = 0; t != kThreads; ++t)
+    {
+        threads.emplace_back([&, t]
+        {
+            // Every thread walks the words from a different starting point
+            // so that they race on inserting the same strings.
+            auto& out = seen[t];
+            out.resize(words.size());
+            const auto start = t * words.size() / kThreads;
+            for(std::size_t n = 0; n != words.size(); ++n)
+            {
+                const auto idx = (start + n) % words.size();
+                out[idx] = i.far(words[idx]).data();
+            }
+        });
+    }
+    for(auto& th : threads)
+    {
+        th.join();
+    }
+
+    for(std::size_t t = 1; t != kThreads; ++t)
+    {
+        REQUIRE(seen[t] == seen[0]);
+    }
+    for(std::size_t n = 0; n != words.size(); ++n)
+    {
+        REQUIRE(i.far(words[n]) == words[n]);
+        REQUIRE(i.far(words[n]).data() == seen[0][n]);
+    }
+
+    const std::set<std::string> unique(words.begin(), words.end());
+    const std::set<const char*> ptrs(seen[0].begin(), seen[0].end());
+    REQUIRE(ptrs.size() == unique.size());
+}
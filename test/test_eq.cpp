@@ -0,0 +1,92 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2019 jh0x
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <doctest/doctest.h>
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <strings.h>
+
+#include <intern/default_string_traits.hpp>
+
+namespace x = intern;
+
+///////////////////////////////////////////////////////////////////////
+
+TEST_CASE("eq matches memcmp")
+{
+    std::string a;
+    for(std::size_t i = 0; i != 200; ++i)
+    {
+        a.push_back(static_cast<char>('a' + i % 26));
+    }
+    for(std::size_t l = 0; l != a.size(); ++l)
+    {
+        // Exact sized copies so that any read past the end is caught by
+        // the sanitizers
+        std::string b = a.substr(0, l);
+        const char* pa = a.data();
+        REQUIRE(x::default_string_traits::eq(pa, b.data(), l));
+        for(std::size_t i = 0; i != l; ++i)
+        {
+            b[i] ^= 0x20;
+            REQUIRE(!x::default_string_traits::eq(pa, b.data(), l));
+            REQUIRE((std::memcmp(pa, b.data(), l) == 0)
+                    == x::default_string_traits::eq(pa, b.data(), l));
+            b[i] ^= 0x20;
+        }
+    }
+}
+
+namespace
+{
+// Orders without case but keeps the eq of default_string_traits
+struct NoCase : x::default_string_traits
+{
+    inline static int cmp(const char* a, const char* b, std::size_t sz)
+    {
+        return ::strncasecmp(a, b, sz);
+    }
+};
+// Its own eq wins
+struct NoCaseEq : NoCase
+{
+    inline static bool eq(const char* a, const char* b, std::size_t sz)
+    {
+        return !std::memcmp(a, b, sz);
+    }
+};
+}
+
+TEST_CASE("eq agrees with a cmp of the string traits")
+{
+    REQUIRE(!x::details::eq_from_cmp<x::default_string_traits>());
+    REQUIRE(x::details::eq_from_cmp<NoCase>());
+    REQUIRE(!x::details::eq_from_cmp<NoCaseEq>());
+
+    REQUIRE(x::details::traits_eq<x::default_string_traits>("ab", "ab", 2));
+    REQUIRE(!x::details::traits_eq<x::default_string_traits>("Ab", "ab", 2));
+    REQUIRE(x::details::traits_eq<NoCase>("Ab", "aB", 2));
+    REQUIRE(!x::details::traits_eq<NoCase>("Ab", "ac", 2));
+    REQUIRE(!x::details::traits_eq<NoCaseEq>("Ab", "aB", 2));
+}
@@ -0,0 +1,179 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2019 jh0x
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "test_interner.h"
+
+#include <intern/flat_map.hpp>
+
+#include <map>
+#include <stdexcept>
+
+namespace
+{
+
+template<typename Intern>
+void check_counts(Intern intern)
+{
+    using StringT = decltype(intern(std::string{}));
+    x::flat_map<StringT, int> counts;
+    std::map<std::string, int> expected;
+    for(auto& s : words)
+    {
+        ++counts[intern(s)];
+        ++expected[s];
+    }
+    REQUIRE(counts.size() == expected.size());
+    for(auto& kv : expected)
+    {
+        REQUIRE(counts.at(intern(kv.first)) == kv.second);
+    }
+    std::size_t seen = 0;
+    for(const auto& kv : counts)
+    {
+        REQUIRE(expected.at(std::string(kv.first.data(), kv.first.size()))
+                == kv.second);
+        ++seen;
+    }
+    REQUIRE(seen == expected.size());
+
+    // Erase every other key, then put them back
+    std::size_t k = 0;
+    for(auto& kv : expected)
+    {
+        if(k++ % 2)
+        {
+            REQUIRE(counts.erase(intern(kv.first)) == 1);
+            REQUIRE(!counts.contains(intern(kv.first)));
+        }
+    }
+    REQUIRE(counts.size() == expected.size() / 2 + expected.size() % 2);
+    for(auto& kv : expected)
+    {
+        counts.try_emplace(intern(kv.first), kv.second);
+    }
+    REQUIRE(counts.size() == expected.size());
+    for(auto& kv : expected)
+    {
+        REQUIRE(counts.find(intern(kv.first))->second == kv.second);
+    }
+}
+
+}
+
+TEST_CASE("flat_map over interned keys")
+{
+    x::interner<interner_traits4> i;
+    for_each_string_type(i, [](auto intern) { check_counts(intern); });
+}
+
+TEST_CASE("flat_map copies, moves and owns its values")
+{
+    x::interner<interner_traits4> i;
+    using map_t = x::flat_map<x::string_far<Default>, std::string>;
+    map_t m;
+    for(auto& s : words)
+    {
+        m.try_emplace(i.far(s), s + "!");
+    }
+    const map_t copy = m;
+    map_t moved = std::move(m);
+    REQUIRE(copy.size() == moved.size());
+    for(auto& s : words)
+    {
+        REQUIRE(copy.at(i.far(s)) == s + "!");
+        REQUIRE(moved.at(i.far(s)) == s + "!");
+    }
+    REQUIRE(copy.find(i.far("not in there")) == copy.end());
+    REQUIRE(!moved.insert({i.far(words[0]), "x"}).second);
+    moved.clear();
+    REQUIRE(moved.empty());
+    REQUIRE(moved.begin() == moved.end());
+    REQUIRE(copy.count(i.far(words[0])) == 1);
+}
+
+TEST_CASE("flat_map without a table")
+{
+    x::interner<interner_traits4> i;
+    using map_t = x::flat_map<x::string_far<Default>, int>;
+    map_t m;
+    REQUIRE(m.bytes() == 0);
+    REQUIRE(m.begin() == m.end());
+    REQUIRE(m.find(i.far(words[0])) == m.end());
+    REQUIRE(m.erase(i.far(words[0])) == 0);
+    m.prefetch(i.far(words[0]));
+    m.reserve(0);
+    REQUIRE(m.bytes() == 0);
+    m[i.far(words[0])] = 1;
+    map_t moved = std::move(m);
+    REQUIRE(m.empty());
+    REQUIRE(m.find(i.far(words[0])) == m.end());
+    m[i.far(words[1])] = 2;
+    REQUIRE(m.size() == 1);
+    REQUIRE(moved.at(i.far(words[0])) == 1);
+}
+
+#ifdef __cpp_exceptions
+TEST_CASE("flat_map keeps no slot for a throwing value")
+{
+    // Not trivially destructible: a slot kept for it would be destroyed
+    struct throwing
+    {
+        explicit throwing(int i) : n(i), s(words[i < 0 ? 0 : i])
+        {
+            if(i < 0)
+            {
+                throw std::runtime_error("throwing");
+            }
+        }
+        int n;
+        std::string s;
+    };
+    x::interner<interner_traits4> i;
+    x::flat_map<x::string_far<Default>, throwing> m;
+    for(std::size_t n = 0; n != words.size(); ++n)
+    {
+        const int v = n % 3 ? static_cast<int>(n) : -1;
+        const auto k = i.far(words[n]);
+        if(m.find(k) != m.end())
+        {
+            continue;
+        }
+        if(v < 0)
+        {
+            REQUIRE_THROWS_AS(m.try_emplace(k, v), std::runtime_error);
+            REQUIRE(m.find(k) == m.end());
+        }
+        else
+        {
+            m.try_emplace(k, v);
+        }
+    }
+    std::size_t count = 0;
+    for(const auto& kv : m)
+    {
+        REQUIRE(kv.second.n % 3 != 0);
+        REQUIRE(std::string(kv.first.data(), kv.first.size()) == kv.second.s);
+        ++count;
+    }
+    REQUIRE(count == m.size());
+}
+#endif
@@ -0,0 +1,129 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2019 jh0x
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "test_interner.h"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <intern/string_ops.hpp>
+
+namespace
+{
+
+// Every string lands on the same cache entry with the same hash
+struct constant_hash
+{
+    std::size_t operator()(const char*, std::size_t) const noexcept
+    {
+        return 42;
+    }
+};
+struct cached_traits : interner_traits4
+{
+    using hasherT = constant_hash;
+    constexpr static std::size_t front_cache = 64;
+};
+
+}
+
+///////////////////////////////////////////////////////////////////////
+
+TEST_CASE("front cache in front of a concurrent interner")
+{
+    using interner_traits = x::interner_sample_cached_traits<(1 << 20)>;
+    using interner_t = x::interner<interner_traits>;
+    interner_t i;
+    const auto before = interner_t::front_cache_stats();
+
+    constexpr std::size_t kThreads = 4;
+    constexpr std::size_t kRounds = 10;
+    std::vector<std::vector<const char*>> seen(kThreads);
+    std::vector<std::thread> threads;
+    for(std::size_t t = 0; t != kThreads; ++t)
+    {
+        threads.emplace_back([&, t]
+        {
+            auto& out = seen[t];
+            out.resize(words.size());
+            // A few hot strings, over and over
+            for(std::size_t r = 0; r != kRounds; ++r)
+            {
+                for(std::size_t n = 0; n != 100; ++n)
+                {
+                    out[n] = i.far(words[n]).data();
+                }
+            }
+            for(std::size_t n = 0; n != words.size(); ++n)
+            {
+                out[n] = i.far(words[n]).data();
+            }
+        });
+    }
+    for(auto& th : threads)
+    {
+        th.join();
+    }
+    for(std::size_t t = 1; t != kThreads; ++t)
+    {
+        REQUIRE(seen[t] == seen[0]);
+    }
+    for(std::size_t n = 0; n != words.size(); ++n)
+    {
+        REQUIRE(i.far(words[n]).data() == seen[0][n]);
+    }
+
+    // Counters of threads that are gone are kept
+    const auto after = interner_t::front_cache_stats();
+    const auto calls = kThreads * (kRounds * 100 + words.size())
+        + words.size();
+    REQUIRE(after.hits + after.misses - before.hits - before.misses == calls);
+    REQUIRE(after.hits - before.hits >= kThreads * (kRounds - 1) * 100);
+}
+
+TEST_CASE("front cache never returns a wrong string")
+{
+    x::interner<cached_traits> a, b;
+    // Same hash and length, different characters
+    const auto abc = a.far("abc");
+    const auto abd = a.far("abd");
+    REQUIRE(abc == std::string("abc"));
+    REQUIRE(abd == std::string("abd"));
+    REQUIRE(a.far("abc").data() == abc.data());
+    REQUIRE(a.far("abd").data() == abd.data());
+
+    // Another instance of the same type shares the thread's cache
+    const auto b_abc = b.far("abc");
+    REQUIRE(b_abc == std::string("abc"));
+    REQUIRE(b_abc.data() != abc.data());
+    REQUIRE(a.far("abc").data() == abc.data());
+    REQUIRE(b.far("abc").data() == b_abc.data());
+
+    for(auto& s : words)
+    {
+        REQUIRE(a.far(s) == s);
+        REQUIRE(a.tiny(s) == s);
+        REQUIRE(a.sso1<16>(s) == s);
+        REQUIRE(a.sso2<24>(s) == s);
+    }
+}
@@ -0,0 +1,63 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2019 jh0x
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "test_interner.h"
+
+#include <string>
+#include <vector>
+
+#include <intern/frozen_interner.hpp>
+
+///////////////////////////////////////////////////////////////////////
+
+TEST_CASE("frozen interner")
+{
+    interner_traits1::raze();
+    x::interner<interner_traits1> i;
+
+    {
+        const auto empty = i.freeze();
+        REQUIRE(empty.size() == 0);
+        REQUIRE(!empty.find("SPY"));
+        REQUIRE(!empty.find(""));
+    }
+
+    for(auto& s : words)
+    {
+        i.far(s);
+    }
+    const auto frozen = i.freeze();
+    REQUIRE(frozen.size() > 0);
+    REQUIRE(frozen.size() <= words.size());
+    for(auto& s : words)
+    {
+        const auto f = frozen.find(s);
+        REQUIRE(f);
+        REQUIRE(f->data() == i.far(s).data());
+        REQUIRE(*f == i.far(s));
+    }
+    REQUIRE(!frozen.find("this word is certainly not in the list"));
+    REQUIRE(!frozen.find(words[0] + words[1] + "#"));
+
+    // Pilots + one pointer per string
+    REQUIRE(frozen.index_bytes() < frozen.size() * 12);
+}
@@ -0,0 +1,76 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2019 jh0x
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <doctest/doctest.h>
+
+#include <cstddef>
+#include <set>
+#include <string>
+
+#include <intern/hash.hpp>
+
+namespace x = intern;
+
+///////////////////////////////////////////////////////////////////////
+
+TEST_CASE("fast_hash vector and scalar paths agree")
+{
+    std::string buf;
+    for(std::size_t i = 0; i != 4096; ++i)
+    {
+        buf.push_back(static_cast<char>(i * 131 + 7));
+    }
+    // Lengths cross every path and block boundary, offsets every alignment
+    for(std::size_t o = 0; o != 8; ++o)
+    {
+        for(std::size_t l = 0; l + o <= 2200; ++l)
+        {
+            const auto* p = buf.data() + o;
+            REQUIRE(x::fast_hash{}(p, l) == x::fast_hash::hash(p, l));
+        }
+    }
+}
+
+TEST_CASE("fast_hash spreads")
+{
+    std::string buf(300, 'a');
+    std::set<std::size_t> seen;
+    for(std::size_t l = 0; l <= buf.size(); ++l)
+    {
+        seen.insert(x::fast_hash{}(buf.data(), l));
+    }
+    // Single bit flips at every position of a long input
+    for(std::size_t i = 0; i != buf.size(); ++i)
+    {
+        auto s = buf;
+        s[i] ^= 1;
+        seen.insert(x::fast_hash{}(s.data(), s.size()));
+    }
+    CHECK(seen.size() == 2 * buf.size() + 1);
+}
+
+TEST_CASE("fast_hash in constant expressions")
+{
+    constexpr auto h = x::fast_hash::hash("NYSE", 4);
+    static_assert(h != 0, "");
+    CHECK(h == x::fast_hash{}("NYSE", 4));
+}
@@ -0,0 +1,212 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2019 jh0x
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "test_interner.h"
+
+#include <intern/scoped_interner.hpp>
+
+#include <atomic>
+#include <cstdio>
+#include <set>
+#include <thread>
+#include <unordered_set>
+
+TEST_CASE("ids are dense and in order of interning")
+{
+    x::interner<interner_traits4, DefaultHashId> i;
+    std::vector<std::string> order;
+    std::set<std::string> seen;
+    for(auto& s : words)
+    {
+        const auto id = i.id(s);
+        if(seen.insert(s).second)
+        {
+            REQUIRE(id.value() == order.size());
+            order.push_back(s);
+        }
+        REQUIRE(i.far(id) == i.far(s));
+        REQUIRE(i.far(s).id() == id);
+    }
+    REQUIRE(i.size() == order.size());
+
+    // Side table indexed by id
+    std::vector<std::size_t> counts(i.size());
+    for(auto& s : words)
+    {
+        ++counts[i.id(s).value()];
+    }
+    for(std::size_t k = 0; k != order.size(); ++k)
+    {
+        REQUIRE(i.far(x::string_id(k)) == order[k]);
+        REQUIRE(counts[k] == std::size_t(
+                    std::count(words.begin(), words.end(), order[k])));
+    }
+}
+
+TEST_CASE("string_id")
+{
+    static_assert(sizeof(x::string_id) == 4, "Size problem");
+    REQUIRE(!x::string_id{}.valid());
+    REQUIRE(x::string_id(3) == x::string_id(3));
+    REQUIRE(x::string_id(3) != x::string_id(4));
+    REQUIRE(x::string_id(3) < x::string_id(4));
+
+    x::interner<interner_traits4, DefaultId> i;
+    std::unordered_set<x::string_id> ids;
+    for(auto& s : words)
+    {
+        ids.insert(i.id(s));
+    }
+    REQUIRE(ids.size() == i.size());
+}
+
+TEST_CASE("ids with a compact index")
+{
+    x::interner<interner_traits5, DefaultId> i;
+    for(auto& s : words)
+    {
+        const auto f = i.far(s);
+        REQUIRE(f.id().value() < i.size());
+        REQUIRE(i.far(f.id()).data() == f.data());
+    }
+}
+
+TEST_CASE("ids from several threads")
+{
+    using interner_traits = x::interner_sample_concurrent_traits<(1 << 20)>;
+    x::interner<interner_traits, DefaultId> i;
+
+    constexpr std::size_t kThreads = 4;
+    std::vector<std::thread> threads;
+    for(std::size_t t = 0; t != kThreads; ++t)
+    {
+        threads.emplace_back([&, t]
+        {
+            for(std::size_t k = 0; k != words.size(); ++k)
+            {
+                const auto& s = words[(k + t * 997) % words.size()];
+                const auto f = i.far(s);
+                REQUIRE(i.far(f.id()).data() == f.data());
+            }
+        });
+    }
+    for(auto& t : threads)
+    {
+        t.join();
+    }
+
+    // Every id below size() is taken exactly once
+    std::vector<bool> taken(i.size());
+    for(auto& s : std::set<std::string>(words.begin(), words.end()))
+    {
+        const auto id = i.find(s)->id().value();
+        REQUIRE(id < taken.size());
+        REQUIRE(!taken[id]);
+        taken[id] = true;
+    }
+}
+
+TEST_CASE("find(id) next to far() from other threads")
+{
+    using interner_traits = x::interner_sample_concurrent_traits<(1 << 20)>;
+    x::interner<interner_traits, DefaultId> i;
+
+    // An id may be counted before its string is stored: find(id) gives
+    // either nothing or the whole string
+    std::atomic<bool> done{false};
+    std::thread reader([&]
+    {
+        while(!done.load(std::memory_order_acquire))
+        {
+            for(std::uint32_t id = 0; id != words.size(); ++id)
+            {
+                if(const auto f = i.find(x::string_id(id)))
+                {
+                    REQUIRE(f->id().value() == id);
+                }
+            }
+        }
+    });
+    std::vector<std::thread> writers;
+    for(std::size_t t = 0; t != 2; ++t)
+    {
+        writers.emplace_back([&, t]
+        {
+            for(std::size_t k = 0; k != words.size(); ++k)
+            {
+                i.far(words[(k + t * 997) % words.size()]);
+            }
+        });
+    }
+    for(auto& t : writers)
+    {
+        t.join();
+    }
+    done.store(true, std::memory_order_release);
+    reader.join();
+}
+
+TEST_CASE("ids survive save() and load()")
+{
+    const char* file = "test_ids.intern";
+    std::vector<std::string> order;
+    {
+        x::interner<interner_traits4, DefaultId> i;
+        for(auto& s : words)
+        {
+            if(i.id(s).value() == order.size())
+            {
+                order.push_back(s);
+            }
+        }
+        REQUIRE(i.save(file));
+    }
+
+    x::interner<interner_traits4, DefaultId> i;
+    REQUIRE(i.load(file));
+    for(std::size_t k = 0; k != order.size(); ++k)
+    {
+        REQUIRE(i.far(x::string_id(k)) == order[k]);
+        REQUIRE(i.id(order[k]).value() == k);
+    }
+    // New strings carry on after the mapped ones
+    REQUIRE(i.id("not a word at all").value() == order.size());
+
+    // Not the same metadata layout
+    x::interner<interner_traits4, DefaultHash> other;
+    REQUIRE(!other.load(file));
+    std::remove(file);
+}
+
+TEST_CASE("scoped strings have no id")
+{
+    using interner_t = x::interner<interner_traits4, DefaultId>;
+    interner_t parent;
+    const auto kept = parent.far("kept");
+    x::scoped_interner<interner_t> scope(parent);
+    REQUIRE(scope.far("kept").id() == kept.id());
+    const auto mine = scope.far("only in the scope").id();
+    REQUIRE(!mine.valid());
+    REQUIRE(!parent.find(mine));
+    REQUIRE(!parent.find(x::string_id(parent.size())));
+    REQUIRE(*parent.find(kept.id()) == kept);
+}
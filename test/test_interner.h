@@ -27,8 +27,12 @@
 
 #include <algorithm>
 #include <fstream>
+#include <iterator>
 #include <vector>
 #include <string>
+#ifdef INTERN_HAS_STRING_VIEW
+#include <string_view>
+#endif
 
 #include <cstring>
 
@@ -91,6 +95,21 @@ TEST_CASE_TEMPLATE_DEFINE("interner", T, test_id)
             REQUIRE(std::equal(
                         s.rbegin(), s.rend(),
                         is.crbegin(), is.crend()));
+            if constexpr(T::string_traits::metadata_store_hash)
+            {
+                if(!is.small())
+                {
+                    REQUIRE(is.hash() == static_cast<std::uint32_t>(
+                                hash_sv{}(s.data(), s.size())));
+                }
+                REQUIRE(is.hash() == T::intern(i, s).hash());
+            }
+            if constexpr(T::string_traits::metadata_store_id)
+            {
+                const auto f = i.far(s);
+                REQUIRE(f.id().valid());
+                REQUIRE(i.far(f.id()).data() == f.data());
+            }
         }
     }
     {
@@ -119,6 +138,22 @@ TEST_CASE_TEMPLATE_DEFINE("interner", T, test_id)
                     ));
 
     }
+#ifdef INTERN_HAS_STRING_VIEW
+    {
+        const std::vector<std::string_view> views(words.begin(), words.end());
+        const auto batch = T::intern_batch(i, views);
+        REQUIRE(batch.size() == words.size());
+        for(std::size_t n = 0; n != words.size(); ++n)
+        {
+            REQUIRE(batch[n] == words[n]);
+            REQUIRE(batch[n].size() == words[n].size());
+            if(!batch[n].small())
+            {
+                REQUIRE(batch[n].data() == i.far(words[n]).data());
+            }
+        }
+    }
+#endif
     {
         phmap::parallel_flat_hash_map<std::string, int> nmap;
         phmap::parallel_flat_hash_map<stringT, int> imap;
@@ -207,6 +242,16 @@ struct test_far_string
     {
         return i.far(std::forward<Args>(args)...);
     }
+#ifdef INTERN_HAS_STRING_VIEW
+    template<typename I, typename In>
+    static auto intern_batch(I& i, const In& in)
+    {
+        std::vector<decltype(intern(i, ""))> out;
+        out.reserve(in.size());
+        i.far_batch(in, std::back_inserter(out));
+        return out;
+    }
+#endif
 };
 
 template<typename InternerTraits, typename StringTraits>
@@ -219,6 +264,16 @@ struct test_sso_tiny
     {
         return i.tiny(std::forward<Args>(args)...);
     }
+#ifdef INTERN_HAS_STRING_VIEW
+    template<typename I, typename In>
+    static auto intern_batch(I& i, const In& in)
+    {
+        std::vector<decltype(intern(i, ""))> out;
+        out.reserve(in.size());
+        i.tiny_batch(in, std::back_inserter(out));
+        return out;
+    }
+#endif
 };
 
 template<typename InternerTraits, std::size_t S, typename StringTraits>
@@ -231,6 +286,16 @@ struct test_sso_v1_string
     {
         return i.template sso1<S>(std::forward<Args>(args)...);
     }
+#ifdef INTERN_HAS_STRING_VIEW
+    template<typename I, typename In>
+    static auto intern_batch(I& i, const In& in)
+    {
+        std::vector<decltype(intern(i, ""))> out;
+        out.reserve(in.size());
+        i.template sso1_batch<S>(in, std::back_inserter(out));
+        return out;
+    }
+#endif
 };
 
 template<typename InternerTraits, std::size_t S, typename StringTraits>
@@ -243,6 +308,38 @@ struct test_sso_v2_string
     {
         return i.template sso1<S>(std::forward<Args>(args)...);
     }
+#ifdef INTERN_HAS_STRING_VIEW
+    template<typename I, typename In>
+    static auto intern_batch(I& i, const In& in)
+    {
+        std::vector<typename I::template stringS2<S>> out;
+        out.reserve(in.size());
+        i.template sso2_batch<S>(in, std::back_inserter(out));
+        return out;
+    }
+#endif
+};
+
+template<typename InternerTraits, std::size_t S, typename StringTraits>
+struct test_sso_v3_string
+{
+    using interner_traits = InternerTraits;
+    using string_traits = StringTraits;
+    template<typename I, typename... Args>
+    static auto intern(I& i, Args... args)
+    {
+        return i.template sso3<S>(std::forward<Args>(args)...);
+    }
+#ifdef INTERN_HAS_STRING_VIEW
+    template<typename I, typename In>
+    static auto intern_batch(I& i, const In& in)
+    {
+        std::vector<typename I::template stringS3<S>> out;
+        out.reserve(in.size());
+        i.template sso3_batch<S>(in, std::back_inserter(out));
+        return out;
+    }
+#endif
 };
 
 ///////////////////////////////////////////////////////////////////////
@@ -283,9 +380,51 @@ struct Default64 : Default
     using size_type = std::uint64_t;
 };
 
+struct DefaultHash : Default
+{
+    constexpr static auto metadata_store_hash = true;
+};
+
+struct DefaultId : Default
+{
+    constexpr static auto metadata_store_id = true;
+};
+struct DefaultHashId : DefaultHash
+{
+    constexpr static auto metadata_store_id = true;
+};
+
+struct DefaultRank : Default
+{
+    constexpr static auto metadata_store_rank = true;
+};
+
+struct DefaultShort : Default
+{
+    using size_type = std::uint32_t;
+    constexpr static auto metadata_short_size = true;
+};
+struct DefaultShortAll : DefaultHashId
+{
+    using size_type = std::uint64_t;
+    constexpr static auto metadata_short_size = true;
+};
+
 ///////////////////////////////////////////////////////////////////////
 // Test invocation
 
+// f(intern) once per string type, intern(s) giving s as that type from i:
+// far, tiny, sso1<16>, sso2<24> and sso3<24>
+template<typename I, typename F>
+void for_each_string_type(I& i, F&& f)
+{
+    f([&i](const std::string& s) { return i.far(s); });
+    f([&i](const std::string& s) { return i.tiny(s); });
+    f([&i](const std::string& s) { return i.template sso1<16>(s); });
+    f([&i](const std::string& s) { return i.template sso2<24>(s); });
+    f([&i](const std::string& s) { return i.template sso3<24>(s); });
+}
+
 #define TEST_IT(traits)                                           \
 TYPE_TO_STRING(test_far_string<interner_traits1, traits>);        \
 TYPE_TO_STRING(test_sso_tiny<interner_traits1, traits>);          \
@@ -295,6 +434,7 @@ TYPE_TO_STRING(test_sso_v1_string<interner_traits1, 32, traits>); \
 TYPE_TO_STRING(test_sso_v2_string<interner_traits1, 16, traits>); \
 TYPE_TO_STRING(test_sso_v2_string<interner_traits1, 24, traits>); \
 TYPE_TO_STRING(test_sso_v2_string<interner_traits1, 32, traits>); \
+TYPE_TO_STRING(test_sso_v3_string<interner_traits1, 24, traits>); \
 TYPE_TO_STRING(test_far_string<interner_traits2, traits>);        \
 TYPE_TO_STRING(test_sso_tiny<interner_traits2, traits>);          \
 TYPE_TO_STRING(test_sso_v1_string<interner_traits2, 16, traits>); \
@@ -303,6 +443,7 @@ TYPE_TO_STRING(test_sso_v1_string<interner_traits2, 32, traits>); \
 TYPE_TO_STRING(test_sso_v2_string<interner_traits2, 16, traits>); \
 TYPE_TO_STRING(test_sso_v2_string<interner_traits2, 24, traits>); \
 TYPE_TO_STRING(test_sso_v2_string<interner_traits2, 32, traits>); \
+TYPE_TO_STRING(test_sso_v3_string<interner_traits2, 24, traits>); \
 TEST_CASE_TEMPLATE_INVOKE(                                        \
         test_id                                                   \
         , test_far_string<interner_traits1, traits>               \
@@ -313,6 +454,7 @@ TEST_CASE_TEMPLATE_INVOKE(                                        \
         , test_sso_v2_string<interner_traits1, 16, traits>        \
         , test_sso_v2_string<interner_traits1, 24, traits>        \
         , test_sso_v2_string<interner_traits1, 32, traits>        \
+        , test_sso_v3_string<interner_traits1, 24, traits>        \
         , test_far_string<interner_traits2, traits>               \
         , test_sso_tiny<interner_traits2, traits>                 \
         , test_sso_v1_string<interner_traits2, 16, traits>        \
@@ -321,5 +463,6 @@ TEST_CASE_TEMPLATE_INVOKE(                                        \
         , test_sso_v2_string<interner_traits2, 16, traits>        \
         , test_sso_v2_string<interner_traits2, 24, traits>        \
         , test_sso_v2_string<interner_traits2, 32, traits>        \
+        , test_sso_v3_string<interner_traits2, 24, traits>        \
         );
 
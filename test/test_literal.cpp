@@ -0,0 +1,124 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2019 jh0x
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "test_interner.h"
+
+#include <intern/literal.hpp>
+
+#include <thread>
+
+namespace
+{
+
+// No constexpr static hash()
+struct runtime_hash
+{
+    std::size_t operator()(const char* s, std::size_t l) const noexcept
+    {
+        return hash_sv{}(s, l);
+    }
+};
+struct runtime_hash_traits : interner_traits4
+{
+    using hasherT = runtime_hash;
+};
+
+template<typename I>
+x::string_far<x::default_string_traits> exchange(I& i)
+{
+    return INTERN_LITERAL(i, "NYSE");
+}
+
+}
+
+TEST_CASE("literals are hashed at compile time")
+{
+    using lit = x::literal<x::interner_sample_hash>;
+    static_assert(lit::hashed, "no constexpr hash");
+    constexpr lit nyse{"NYSE"};
+    static_assert(nyse._size == 4, "Size problem");
+    static_assert(nyse._hash == x::fast_hash::hash("NYSE", 4), "Hash problem");
+    REQUIRE(nyse._hash == x::interner_sample_hash{}("NYSE", 4));
+
+    constexpr lit longer{"a literal longer than sixteen bytes, for the 17 to "
+        "128 byte path of the hash"};
+    REQUIRE(longer._hash == x::interner_sample_hash{}(
+                longer._data, longer._size));
+
+    static_assert(!x::literal<runtime_hash>::hashed, "unexpected hash");
+}
+
+TEST_CASE("INTERN_LITERAL")
+{
+    x::interner<interner_traits4> i;
+    const auto a = INTERN_LITERAL(i, "NYSE");
+    REQUIRE(a == i.far("NYSE"));
+    REQUIRE(i.size() == 1);
+    for(int k = 0; k != 3; ++k)
+    {
+        // Same call site: the kept string_far, same call site and interner
+        REQUIRE(exchange(i).data() == a.data());
+    }
+    REQUIRE(INTERN_LITERAL(i, "NASDAQ") == i.far("NASDAQ"));
+    REQUIRE(INTERN_LITERAL(i, "") == i.far(""));
+    REQUIRE(i.size() == 3);
+
+    // Every interner has its own slots
+    x::interner<interner_traits4> j;
+    REQUIRE(exchange(j) == j.far("NYSE"));
+    REQUIRE(exchange(j).data() != exchange(i).data());
+    REQUIRE(exchange(i).data() == a.data());
+}
+
+TEST_CASE("INTERN_LITERAL without a constexpr hash")
+{
+    x::interner<runtime_hash_traits> i;
+    const auto a = INTERN_LITERAL(i, "XLON");
+    REQUIRE(a == i.far("XLON"));
+    REQUIRE(INTERN_LITERAL(i, "XLON") == a);
+}
+
+TEST_CASE("INTERN_LITERAL from several threads")
+{
+    using interner_traits = x::interner_sample_concurrent_traits<(1 << 20)>;
+    x::interner<interner_traits> i;
+    std::vector<const char*> seen(4);
+    std::vector<std::thread> threads;
+    for(std::size_t t = 0; t != seen.size(); ++t)
+    {
+        threads.emplace_back([&, t]
+        {
+            for(int k = 0; k != 1000; ++k)
+            {
+                seen[t] = exchange(i).data();
+            }
+        });
+    }
+    for(auto& t : threads)
+    {
+        t.join();
+    }
+    for(auto* p : seen)
+    {
+        REQUIRE(p == i.far("NYSE").data());
+    }
+}
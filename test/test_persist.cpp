@@ -0,0 +1,246 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2019 jh0x
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "test_interner.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <set>
+
+namespace
+{
+
+const char* kFile = "test_persist.intern";
+
+struct OtherHash
+{
+    std::size_t operator()(const char* s, std::size_t l) const noexcept
+    {
+        return hash_sv{}(s, l) ^ 1;
+    }
+};
+struct interner_traits_other_hash : interner_traits4
+{
+    using hasherT = OtherHash;
+};
+
+template<typename ITraits, typename STraits>
+void check_roundtrip()
+{
+    std::set<std::string> distinct(words.begin(), words.end());
+    {
+        x::interner<ITraits, STraits> i;
+        for(auto& s : words)
+        {
+            i.far(s);
+        }
+        REQUIRE(i.save(kFile));
+    }
+
+    x::interner<ITraits, STraits> i;
+    REQUIRE(i.load(kFile));
+    REQUIRE(i.size() == distinct.size());
+    for(auto& s : words)
+    {
+        const auto f = i.far(s);
+        REQUIRE(f == s);
+        REQUIRE(f.data() == i.far(s).data());
+        if constexpr(STraits::metadata_store_hash)
+        {
+            REQUIRE(f.hash() == static_cast<std::uint32_t>(
+                        hash_sv{}(s.data(), s.size())));
+        }
+    }
+    // Served from the mapping without a single allocation
+    REQUIRE(i.allocator().used() == 0);
+
+    // New strings go on top
+    const auto extra = i.far("not in the file, surely");
+    REQUIRE(i.allocator().used() > 0);
+    REQUIRE(i.size() == distinct.size() + 1);
+    REQUIRE(extra.data() == i.far("not in the file, surely").data());
+
+    const auto frozen = i.freeze();
+    REQUIRE(frozen.size() == i.size());
+    REQUIRE(frozen.find("not in the file, surely")->data() == extra.data());
+    REQUIRE(frozen.find(words[7])->data() == i.far(words[7]).data());
+
+    // Saving a loaded interner keeps both layers
+    REQUIRE(i.save(kFile));
+    x::interner<ITraits, STraits> j;
+    REQUIRE(j.load(kFile));
+    REQUIRE(j.size() == distinct.size() + 1);
+    j.far("not in the file, surely");
+    j.far(words[3]);
+    REQUIRE(j.allocator().used() == 0);
+}
+
+}
+
+TEST_CASE("persisted interner round trip")
+{
+    check_roundtrip<interner_traits4, Default>();
+    check_roundtrip<interner_traits4, DefaultHash>();
+    check_roundtrip<interner_traits5, Default>();
+    std::remove(kFile);
+}
+
+TEST_CASE("persisted interner refuses what it cannot use")
+{
+    {
+        x::interner<interner_traits4> i;
+        i.far("SPY");
+        REQUIRE(i.save(kFile));
+    }
+    // Different hasher, different string traits, non-empty interner
+    x::interner<interner_traits_other_hash> other;
+    REQUIRE(!other.load(kFile));
+    x::interner<interner_traits4, Default32> wide;
+    REQUIRE(!wide.load(kFile));
+    x::interner<interner_traits4> used;
+    used.far("QQQ");
+    REQUIRE(!used.load(kFile));
+
+    // Truncated and missing files
+    {
+        std::ifstream in(kFile, std::ios::binary);
+        std::string bytes((std::istreambuf_iterator<char>(in)),
+                std::istreambuf_iterator<char>());
+        std::ofstream out(kFile, std::ios::binary | std::ios::trunc);
+        out.write(bytes.data(), bytes.size() / 2);
+    }
+    x::interner<interner_traits4> i;
+    REQUIRE(!i.load(kFile));
+    std::remove(kFile);
+    REQUIRE(!i.load(kFile));
+
+    // Still usable
+    REQUIRE(i.far("SPY") == std::string("SPY"));
+}
+
+TEST_CASE("persisted interner with corrupt offsets")
+{
+    {
+        x::interner<interner_traits4> i;
+        for(auto& s : words)
+        {
+            i.far(s);
+        }
+        REQUIRE(i.save(kFile));
+    }
+    std::string bytes;
+    {
+        std::ifstream in(kFile, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in),
+                std::istreambuf_iterator<char>());
+    }
+    x::details::persist_header h;
+    std::memcpy(&h, bytes.data(), sizeof(h));
+
+    // The first used slot of the index, set to v
+    constexpr std::uint32_t kNone = std::uint32_t(-1);
+    auto at = h._slots_at;
+    std::uint32_t o;
+    for(;; at += sizeof(o))
+    {
+        std::memcpy(&o, bytes.data() + at, sizeof(o));
+        if(o != kNone)
+        {
+            break;
+        }
+    }
+    // The string of that slot
+    const x::string_far<Default> f{bytes.data() + h._arena_at + o};
+    const std::string first(f.data(), f.size());
+
+    // Loads with the slot set to v: the other strings are still mapped
+    // and that one is interned again, never read from outside the arena
+    const auto load_with = [&](std::uint32_t v)
+    {
+        auto copy = bytes;
+        std::memcpy(&copy[at], &v, sizeof(v));
+        {
+            std::ofstream out(kFile, std::ios::binary | std::ios::trunc);
+            out.write(copy.data(), copy.size());
+        }
+        x::interner<interner_traits4> i;
+        REQUIRE(i.load(kFile));
+        for(auto& s : words)
+        {
+            REQUIRE(i.far(s) == s);
+        }
+        REQUIRE(i.far(first) == first);
+        // Saved again, both layers round trip
+        REQUIRE(i.save(kFile));
+        x::interner<interner_traits4> j;
+        REQUIRE(j.load(kFile));
+        for(auto& s : words)
+        {
+            REQUIRE(j.far(s) == s);
+        }
+    };
+    load_with(o);
+    // Past the arena, inside the header of the first string, or no string
+    load_with(std::uint32_t(h._arena_size) + 100);
+    load_with(1);
+    load_with(kNone);
+
+    // A header whose sections overlap or run past the file is refused
+    const auto load_header = [&](const x::details::persist_header& bad)
+    {
+        auto copy = bytes;
+        std::memcpy(&copy[0], &bad, sizeof(bad));
+        {
+            std::ofstream out(kFile, std::ios::binary | std::ios::trunc);
+            out.write(copy.data(), copy.size());
+        }
+        x::interner<interner_traits4> i;
+        return i.load(kFile);
+    };
+    auto bad = h;
+    bad._table_size = std::uint64_t(-1) / 2;
+    REQUIRE(!load_header(bad));
+    bad = h;
+    bad._arena_size += h._pilots_at;
+    REQUIRE(!load_header(bad));
+    bad = h;
+    bad._count = h._table_size + h._spilled + 1;
+    REQUIRE(!load_header(bad));
+    bad = h;
+    bad._slots_at += 4;
+    REQUIRE(!load_header(bad));
+    std::remove(kFile);
+}
+
+TEST_CASE("empty persisted interner")
+{
+    {
+        x::interner<interner_traits4> i;
+        REQUIRE(i.save(kFile));
+    }
+    x::interner<interner_traits4> i;
+    REQUIRE(i.load(kFile));
+    REQUIRE(i.size() == 0);
+    REQUIRE(i.far("SPY") == std::string("SPY"));
+    std::remove(kFile);
+}
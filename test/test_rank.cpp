@@ -0,0 +1,175 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2019 jh0x
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "test_interner.h"
+
+#include <intern/scoped_interner.hpp>
+
+#include <random>
+
+namespace
+{
+
+using ranked_interner = x::interner<interner_traits4, DefaultRank>;
+using stringF = ranked_interner::stringF;
+
+bool bytes_less(stringF a, stringF b)
+{
+    return std::string(a.data(), a.size()) < std::string(b.data(), b.size());
+}
+
+// Ranks of everything in i agree with the bytes
+void check_order(const std::vector<stringF>& all)
+{
+    auto by_rank = all;
+    std::sort(by_rank.begin(), by_rank.end(),
+            [](stringF a, stringF b) { return a.rank() < b.rank(); });
+    for(std::size_t k = 1; k < by_rank.size(); ++k)
+    {
+        REQUIRE(bytes_less(by_rank[k - 1], by_rank[k]));
+        REQUIRE(by_rank[k - 1] < by_rank[k]);
+        REQUIRE(!(by_rank[k] < by_rank[k - 1]));
+    }
+}
+
+}
+
+TEST_CASE("ranks sort like the strings")
+{
+    ranked_interner i;
+    std::vector<stringF> all;
+    auto shuffled = words;
+    std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937{7});
+    for(auto& s : shuffled)
+    {
+        const auto f = i.far(s);
+        REQUIRE(f.rank() != x::details::kNoRank);
+        if(all.empty() || std::find(all.begin(), all.end(), f) == all.end())
+        {
+            all.push_back(f);
+        }
+    }
+    check_order(all);
+
+    // std::sort over interned strings only compares integers now
+    auto sorted = all;
+    std::sort(sorted.begin(), sorted.end());
+    REQUIRE(std::is_sorted(sorted.begin(), sorted.end(), bytes_less));
+}
+
+TEST_CASE("ranks in order, in reverse and always in the same gap")
+{
+    ranked_interner i;
+    std::vector<stringF> all;
+    for(int k = 0; k != 2000; ++k)
+    {
+        all.push_back(i.far("up" + std::to_string(100000 + k)));
+        all.push_back(i.far("down" + std::to_string(900000 - k)));
+    }
+    REQUIRE(i.relabeled() == 0);
+
+    // "b", "bb", "bbb", ... all go right before "c"
+    all.push_back(i.far("a"));
+    all.push_back(i.far("c"));
+    std::string s;
+    for(int k = 0; k != 3000; ++k)
+    {
+        s += 'b';
+        all.push_back(i.far(s));
+    }
+    REQUIRE(i.relabeled() > 0);
+    REQUIRE(i.relabeled() < 100 * all.size());
+    check_order(all);
+}
+
+TEST_CASE("ranks of small strings, scoped strings and reclaimed strings")
+{
+    ranked_interner i;
+    for(auto& s : words)
+    {
+        i.far(s);
+    }
+
+    // Mixed small/large comparisons fall back to the bytes
+    std::vector<ranked_interner::stringS2<16>> v;
+    for(auto& s : words)
+    {
+        v.push_back(i.sso2<16>(s));
+    }
+    std::sort(v.begin(), v.end());
+    REQUIRE(std::is_sorted(v.begin(), v.end(), [](auto& a, auto& b)
+    {
+        return std::string(a.data(), a.size())
+            < std::string(b.data(), b.size());
+    }));
+
+    // Strings of a scoped interner are not ranked
+    x::scoped_interner<ranked_interner> scope(i);
+    const auto mine = scope.far("zzz only in the scope");
+    REQUIRE(mine.rank() == x::details::kNoRank);
+    REQUIRE(i.far("zebra") < mine);
+    REQUIRE(mine < i.far("zzzz"));
+
+    x::interner<interner_traits6, DefaultRank> r;
+    std::vector<stringF> kept;
+    {
+        std::vector<x::interner<interner_traits6, DefaultRank>::refT> refs;
+        for(std::size_t k = 0; k != words.size(); ++k)
+        {
+            if(k % 2)
+            {
+                refs.push_back(r.ref(words[k]));
+            }
+            else
+            {
+                kept.push_back(r.far(words[k]));
+            }
+        }
+    }
+    for(auto& s : words)
+    {
+        kept.push_back(r.far(s + "!"));
+    }
+    std::sort(kept.begin(), kept.end());
+    kept.erase(std::unique(kept.begin(), kept.end()), kept.end());
+    check_order(kept);
+}
+
+TEST_CASE("ranks of two interners are not compared")
+{
+    ranked_interner a, b;
+    std::vector<stringF> mixed;
+    auto shuffled = words;
+    std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937{11});
+    for(std::size_t k = 0; k != shuffled.size(); ++k)
+    {
+        mixed.push_back(k % 3 ? a.far(shuffled[k]) : b.far(shuffled[k]));
+    }
+    REQUIRE(x::details::metadata_of<DefaultRank>(a.far("SPY").data())._space
+            != x::details::metadata_of<DefaultRank>(b.far("SPY").data())._space);
+    std::sort(mixed.begin(), mixed.end());
+    REQUIRE(std::is_sorted(mixed.begin(), mixed.end(), bytes_less));
+    for(std::size_t k = 1; k < mixed.size(); ++k)
+    {
+        REQUIRE(!(mixed[k] < mixed[k - 1]));
+    }
+}
@@ -0,0 +1,109 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2019 jh0x
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "test_interner.h"
+
+#include <set>
+
+#define TEST_IT_RECLAIM(traits)                                   \
+TYPE_TO_STRING(test_far_string<interner_traits6, traits>);        \
+TYPE_TO_STRING(test_sso_tiny<interner_traits6, traits>);          \
+TYPE_TO_STRING(test_sso_v2_string<interner_traits6, 24, traits>); \
+TEST_CASE_TEMPLATE_INVOKE(                                        \
+        test_id                                                   \
+        , test_far_string<interner_traits6, traits>               \
+        , test_sso_tiny<interner_traits6, traits>                 \
+        , test_sso_v2_string<interner_traits6, 24, traits>        \
+        );
+
+TEST_IT_RECLAIM(Default);
+TEST_IT_RECLAIM(DefaultHash);
+
+using reclaim_interner = x::interner<interner_traits6>;
+
+TEST_CASE("string_ref keeps strings alive")
+{
+    reclaim_interner i;
+    {
+        auto a = i.ref("ORD-1");
+        auto b = i.ref(std::string("ORD-1"));
+        REQUIRE(a == b);
+        REQUIRE(a.get() == std::string("ORD-1"));
+        REQUIRE(i.size() == 1);
+
+        auto c = a;                 // copy
+        auto d = std::move(b);      // move
+        REQUIRE(c.data() == d.data());
+        a = i.ref("ORD-2");         // assignment drops one reference
+        REQUIRE(i.size() == 2);
+    }
+    REQUIRE(i.size() == 0);
+    REQUIRE(i.free_bytes() > 0);
+}
+
+TEST_CASE("reclaimed memory is reused")
+{
+    reclaim_interner i;
+    std::vector<reclaim_interner::refT> live;
+    for(auto& s : words)
+    {
+        live.push_back(i.ref(s));
+    }
+    const std::set<std::string> distinct(words.begin(), words.end());
+    REQUIRE(i.size() == distinct.size());
+    const auto used = i.allocator().used();
+
+    // Over and over: the arena does not grow any more
+    for(int round = 0; round != 5; ++round)
+    {
+        live.clear();
+        REQUIRE(i.size() == 0);
+        for(auto& s : words)
+        {
+            live.push_back(i.ref(s));
+            REQUIRE(live.back().get() == s);
+        }
+        REQUIRE(i.allocator().used() == used);
+    }
+    for(std::size_t n = 0; n != words.size(); ++n)
+    {
+        REQUIRE(i.ref(words[n]).data() == live[n].data());
+    }
+}
+
+TEST_CASE("far() pins reclaimable strings")
+{
+    reclaim_interner i;
+    const char* p;
+    {
+        auto r = i.ref("SESSION-42");
+        p = i.far("SESSION-42").data();
+        REQUIRE(r.data() == p);
+    }
+    REQUIRE(i.size() == 1);
+    REQUIRE(i.far("SESSION-42").data() == p);
+    {
+        auto r = i.ref("SESSION-42");
+    }
+    REQUIRE(i.size() == 1);
+    REQUIRE(i.free_bytes() == 0);
+}
@@ -0,0 +1,126 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2019 jh0x
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "test_interner.h"
+
+#include <intern/scoped_interner.hpp>
+
+#include <set>
+
+TEST_CASE("interner find")
+{
+    interner_traits1::raze();
+    x::interner<interner_traits1> i;
+    REQUIRE(!i.find("SPY"));
+    const auto spy = i.far("SPY");
+    REQUIRE(i.find("SPY")->data() == spy.data());
+    REQUIRE(i.find(std::string("SPY"))->data() == spy.data());
+    REQUIRE(!i.find("SP"));
+    REQUIRE(i.size() == 1);
+
+    x::interner<interner_traits5> c;
+    REQUIRE(!c.find("QQQ"));
+    REQUIRE(c.find("QQQ") == std::nullopt);
+    REQUIRE(c.find(std::string("QQQ")) == std::nullopt);
+    REQUIRE(c.far("QQQ").data() == c.find("QQQ")->data());
+}
+
+TEST_CASE("scoped interner")
+{
+    x::interner<interner_traits4> parent;
+    for(std::size_t n = 0; n < words.size(); n += 2)
+    {
+        parent.far(words[n]);
+    }
+    const auto parent_size = parent.size();
+
+    x::scoped_interner<x::interner<interner_traits4>> scope{parent, 64};
+    std::vector<const char*> first;
+    for(auto& s : words)
+    {
+        const auto f = scope.far(s);
+        REQUIRE(f == s);
+        first.push_back(f.data());
+        if(auto p = parent.find(s))
+        {
+            // From the parent, not copied
+            REQUIRE(p->data() == f.data());
+        }
+    }
+    REQUIRE(parent.size() == parent_size);
+    const std::set<std::string> distinct(words.begin(), words.end());
+    std::set<std::string> own;
+    for(auto& s : words)
+    {
+        if(!parent.find(s))
+        {
+            own.insert(s);
+        }
+    }
+    REQUIRE(scope.size() == own.size());
+    for(std::size_t n = 0; n != words.size(); ++n)
+    {
+        REQUIRE(scope.far(words[n]).data() == first[n]);
+    }
+
+    // Nested marks
+    const auto m1 = scope.mark();
+    const auto used1 = scope.allocator().used();
+    scope.far("request 1 a");
+    scope.far("request 1 b");
+    const auto m2 = scope.mark();
+    const auto c = scope.far("request 1 c");
+    REQUIRE(scope.size() == own.size() + 3);
+    REQUIRE(scope.far("request 1 c").data() == c.data());
+
+    scope.rollback(m2);
+    REQUIRE(scope.size() == own.size() + 2);
+    REQUIRE(scope.far("request 1 a") == std::string("request 1 a"));
+    REQUIRE(scope.size() == own.size() + 2);
+    scope.far("request 1 c");
+    REQUIRE(scope.size() == own.size() + 3);
+
+    scope.rollback(m1);
+    REQUIRE(scope.size() == own.size());
+    REQUIRE(scope.allocator().used() == used1);
+    for(std::size_t n = 0; n != words.size(); ++n)
+    {
+        REQUIRE(scope.far(words[n]).data() == first[n]);
+    }
+    REQUIRE(scope.size() == own.size());
+
+    // Many rounds on the same memory
+    const auto reserved = scope.allocator().reserved();
+    for(int round = 0; round != 10; ++round)
+    {
+        scope.clear();
+        REQUIRE(scope.size() == 0);
+        for(auto& s : words)
+        {
+            REQUIRE(scope.far(s) == s);
+            REQUIRE(scope.tiny(s.data(), s.size()) == s);
+            REQUIRE(scope.sso2<24>(s.data(), s.size()) == s);
+        }
+        REQUIRE(scope.size() == own.size());
+    }
+    REQUIRE(scope.allocator().reserved() == reserved);
+}
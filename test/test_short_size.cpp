@@ -0,0 +1,155 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2019 jh0x
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "test_interner.h"
+
+#include <intern/scoped_interner.hpp>
+
+#include <cstdio>
+#include <stdexcept>
+
+namespace
+{
+
+std::string blob(std::size_t n, char seed)
+{
+    std::string s(n, ' ');
+    for(std::size_t k = 0; k != n; ++k)
+    {
+        s[k] = char('a' + (seed + k * 7) % 26);
+    }
+    return s;
+}
+
+const std::size_t kLengths[] = {
+    0, 1, 100, 65533, 65534, 65535, 65536, 70000, std::size_t(1) << 21};
+
+template<typename STraits>
+void check_lengths()
+{
+    using metadata = x::details::metadata<STraits>;
+    x::interner<interner_traits4, STraits> i;
+    std::vector<std::string> in;
+    for(auto n : kLengths)
+    {
+        in.push_back(blob(n, char(n)));
+    }
+    for(auto& s : in)
+    {
+        const auto f = i.far(s);
+        REQUIRE(f.size() == s.size());
+        REQUIRE(f == i.far(s));
+        REQUIRE(std::string(f.data(), f.size()) == s);
+        REQUIRE(f.data()[f.size()] == '\0');
+        if constexpr(STraits::metadata_store_hash)
+        {
+            REQUIRE(f.hash() == static_cast<std::uint32_t>(
+                        hash_sv{}(s.data(), s.size())));
+        }
+    }
+    REQUIRE(i.size() == in.size());
+
+    // Headers stay as small as with a 16 bit size_type below 65535
+    REQUIRE(x::details::header_bytes<STraits>(65534) == sizeof(metadata));
+    REQUIRE(x::details::header_bytes<STraits>(65535)
+            == sizeof(metadata) + sizeof(typename STraits::size_type));
+    REQUIRE(sizeof(metadata) == sizeof(x::details::metadata<
+                std::conditional_t<STraits::metadata_store_id,
+                    DefaultHashId, Default>>));
+}
+
+}
+
+TEST_CASE("short sizes go past 64 KiB")
+{
+    check_lengths<DefaultShort>();
+    check_lengths<DefaultShortAll>();
+}
+
+TEST_CASE("short sizes with ids, persistence, reclaim and scopes")
+{
+    const char* file = "test_short_size.intern";
+    std::vector<std::string> in;
+    for(auto n : kLengths)
+    {
+        in.push_back(blob(n, char(n + 1)));
+    }
+    {
+        x::interner<interner_traits4, DefaultShortAll> i;
+        for(auto& s : in)
+        {
+            const auto f = i.far(s);
+            REQUIRE(i.far(f.id()).size() == s.size());
+        }
+        REQUIRE(i.save(file));
+    }
+    {
+        x::interner<interner_traits4, DefaultShortAll> i;
+        REQUIRE(i.load(file));
+        for(std::size_t k = 0; k != in.size(); ++k)
+        {
+            const auto f = i.far(x::string_id(k));
+            REQUIRE(std::string(f.data(), f.size()) == in[k]);
+        }
+        std::remove(file);
+
+        x::scoped_interner<decltype(i)> scope(i);
+        const auto big = blob(100000, 'q');
+        const auto f = scope.far(big);
+        REQUIRE(std::string(f.data(), f.size()) == big);
+        REQUIRE(scope.far(in.back()).data() == i.far(in.back()).data());
+    }
+    {
+        x::interner<interner_traits6, DefaultShort> i;
+        for(int round = 0; round != 3; ++round)
+        {
+            using interner_t = x::interner<interner_traits6, DefaultShort>;
+            std::vector<interner_t::refT> live;
+            for(auto& s : in)
+            {
+                live.push_back(i.ref(s));
+                REQUIRE(live.back().size() == s.size());
+            }
+            REQUIRE(i.size() == in.size());
+            live.clear();
+            REQUIRE(i.size() == 0);
+        }
+    }
+}
+
+TEST_CASE("strings longer than size_type are refused, not truncated")
+{
+    x::interner<interner_traits4> i;
+    const auto longest = blob(65535, 'l');
+    REQUIRE(i.far(longest).size() == 65535);
+    const auto over = blob(65536 + 3, 'o');
+    REQUIRE(!i.find(over));
+#ifdef __cpp_exceptions
+    REQUIRE_THROWS_AS(i.far(over), std::length_error);
+    REQUIRE_THROWS_AS(i.sso1<16>(over), std::length_error);
+    x::scoped_interner<decltype(i)> scope(i);
+    REQUIRE_THROWS_AS(scope.far(over), std::length_error);
+    // Nothing of it was interned, e.g. its first 3 bytes
+    REQUIRE(!i.find(over.substr(0, 3)));
+#endif
+    REQUIRE(i.size() == 1);
+}
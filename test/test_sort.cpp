@@ -0,0 +1,101 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2019 jh0x
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "test_interner.h"
+#include <intern/sort.hpp>
+
+namespace
+{
+
+template<typename Intern>
+void check_sort(Intern intern, std::size_t copies, unsigned threads)
+{
+    using StringT = decltype(intern(std::string{}));
+    std::vector<StringT> v;
+    std::vector<std::string> expected;
+    for(std::size_t c = 0; c != copies; ++c)
+    {
+        for(auto& s : words)
+        {
+            // Shared 8 byte prefixes and strings differing in length only
+            const auto t = c % 3 == 0 ? s : c % 3 == 1 ? "prefix::" + s : s + '\0';
+            v.push_back(intern(t));
+            expected.push_back(t);
+        }
+    }
+    std::sort(expected.begin(), expected.end());
+    x::sort(v.begin(), v.end(), threads);
+    REQUIRE(v.size() == expected.size());
+    for(std::size_t k = 0; k != v.size(); ++k)
+    {
+        REQUIRE(std::string(v[k].data(), v[k].size()) == expected[k]);
+    }
+}
+
+template<typename Intern>
+void check_all(Intern intern)
+{
+    check_sort(intern, 1, 1);
+    check_sort(intern, 3, 1);
+    check_sort(intern, 8, 4);
+}
+
+}
+
+TEST_CASE("sort orders interned strings like std::sort")
+{
+    x::interner<interner_traits4> i;
+    for_each_string_type(i, [](auto intern) { check_all(intern); });
+}
+
+TEST_CASE("sort of copies of long strings with a shared prefix")
+{
+    // One pass per 8 shared bytes: must not need as many stack frames
+    x::interner<interner_traits4> i;
+    const std::string prefix(60000, 'p');
+    for_each_string_type(i, [&prefix](auto intern)
+    {
+        std::vector<decltype(intern(prefix))> v;
+        for(std::size_t k = 0; k != 256; ++k)
+        {
+            v.push_back(intern(prefix + (k % 2 ? 'b' : 'a')));
+        }
+        v.push_back(intern(prefix));
+        x::sort(v.begin(), v.end());
+        REQUIRE(v[0].size() == prefix.size());
+        for(std::size_t k = 1; k != v.size(); ++k)
+        {
+            REQUIRE(v[k].back() == (k <= 128 ? 'a' : 'b'));
+        }
+    });
+}
+
+TEST_CASE("sort of empty and single element ranges")
+{
+    x::interner<interner_traits4> i;
+    std::vector<x::string_far<Default>> v;
+    x::sort(v);
+    REQUIRE(v.empty());
+    v.push_back(i.far("one"));
+    x::sort(v, 4);
+    REQUIRE(v[0] == i.far("one"));
+}
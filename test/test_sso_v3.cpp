@@ -0,0 +1,83 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2019 jh0x
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "test_interner.h"
+
+#include <type_traits>
+
+namespace
+{
+
+template<std::size_t S, typename STraits>
+void check_relocation()
+{
+    using interner_t = x::interner<interner_traits4, STraits>;
+    using v3_t = typename interner_t::template stringS3<S>;
+    static_assert(std::is_trivially_copyable<v3_t>::value);
+    static_assert(sizeof(v3_t) == S);
+    interner_t i;
+
+    std::vector<v3_t> v;
+    for(auto& s : words)
+    {
+        v.push_back(i.template sso3<S>(s));   // grows, moving by memcpy
+    }
+    for(std::size_t k = 0; k != words.size(); ++k)
+    {
+        REQUIRE(v[k] == words[k]);
+        REQUIRE(v[k].small() == (words[k].size() <= v3_t::sso_size));
+        if(!v[k].small())
+        {
+            REQUIRE(v[k].data() == i.far(words[k]).data());
+        }
+    }
+
+    // A raw byte copy is a valid copy, small or far
+    alignas(v3_t) unsigned char raw[2][sizeof(v3_t)];
+    const auto small = i.template sso3<S>("abc");
+    const auto far = i.template sso3<S>(std::string(v3_t::sso_size + 1, 'x'));
+    std::memcpy(raw[0], &small, sizeof(v3_t));
+    std::memcpy(raw[1], &far, sizeof(v3_t));
+    const auto& small2 = *reinterpret_cast<const v3_t*>(raw[0]);
+    const auto& far2 = *reinterpret_cast<const v3_t*>(raw[1]);
+    REQUIRE(small2 == "abc");
+    REQUIRE(small2.data()
+            == reinterpret_cast<const char*>(raw[0]) + S - v3_t::_max_size);
+    REQUIRE(far2.data() == far.data());
+
+    auto a = small;
+    auto b = far;
+    a.swap(b);
+    REQUIRE(a == far);
+    REQUIRE(b == "abc");
+    REQUIRE(b.data() != small.data());
+}
+
+}
+
+TEST_CASE("string_sso_v3 is trivially relocatable")
+{
+    check_relocation<16, Default>();
+    check_relocation<24, Default>();
+    check_relocation<32, Default>();
+    check_relocation<24, Default64>();
+}
@@ -0,0 +1,223 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2019 jh0x
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "test_interner.h"
+
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <intern/string_ops.hpp>
+
+namespace
+{
+
+struct counted_traits : interner_traits4
+{
+    constexpr static auto statistics = true;
+};
+struct counted_compact_traits : interner_traits5
+{
+    constexpr static auto statistics = true;
+};
+struct counted_cached_traits : interner_traits4
+{
+    constexpr static auto statistics = true;
+    constexpr static std::size_t front_cache = 64;
+};
+struct counted_concurrent_traits
+    : x::interner_sample_concurrent_traits<(1 << 21)>
+{
+    constexpr static auto statistics = true;
+};
+
+std::size_t distinct_words()
+{
+    x::interner<interner_traits4> i;
+    for(auto& s : words)
+    {
+        i.far(s);
+    }
+    return i.size();
+}
+
+std::uint64_t total(const std::array<std::uint64_t, x::details::kLengthBuckets>& a)
+{
+    return std::accumulate(a.begin(), a.end(), std::uint64_t{0});
+}
+
+}
+
+///////////////////////////////////////////////////////////////////////
+
+TEST_CASE("statistics cost nothing when disabled")
+{
+    REQUIRE(std::is_empty<x::details::stats_state<false, false>>::value);
+    REQUIRE(std::is_empty<x::details::stats_state<false, true>>::value);
+    REQUIRE(!x::details::has_statistics<interner_traits4>::value);
+    REQUIRE(x::details::has_statistics<counted_traits>::value);
+}
+
+TEST_CASE("length buckets")
+{
+    REQUIRE(x::details::length_bucket(0) == 0);
+    REQUIRE(x::details::length_bucket(1) == 1);
+    REQUIRE(x::details::length_bucket(2) == 2);
+    REQUIRE(x::details::length_bucket(3) == 2);
+    REQUIRE(x::details::length_bucket(4) == 3);
+    REQUIRE(x::details::length_bucket(65535) == 16);
+    REQUIRE(x::details::length_bucket(std::size_t(1) << 40) == 16);
+}
+
+TEST_CASE("hits, misses and lengths")
+{
+    x::interner<counted_traits> i;
+    auto st = i.stats();
+    REQUIRE(st.lookups == 0);
+    REQUIRE(st.hits == 0);
+    REQUIRE(st.hit_ratio() <= 0.0);
+
+    std::uint64_t bytes = 0;
+    std::array<std::uint64_t, x::details::kLengthBuckets> lengths{};
+    for(auto& s : words)
+    {
+        if(!i.find(s))
+        {
+            bytes += s.size();
+            ++lengths[x::details::length_bucket(s.size())];
+        }
+        REQUIRE(i.far(s) == s);
+    }
+    for(auto& s : words)
+    {
+        REQUIRE(i.sso1<16>(s) == s);
+    }
+
+    st = i.stats();
+    const auto distinct = distinct_words();
+    REQUIRE(st.distinct == distinct);
+    REQUIRE(st.misses == distinct);
+    REQUIRE(st.string_bytes == bytes);
+    REQUIRE(st.lengths == lengths);
+    REQUIRE(total(st.lengths) == distinct);
+    // Strings that fit sso1<16> never reach the interner
+    std::size_t longer = 0;
+    for(auto& s : words)
+    {
+        longer += s.size() > x::interner<counted_traits>::stringS1<16>::sso_size;
+    }
+    REQUIRE(st.lookups == words.size() + longer);
+    REQUIRE(st.hits == st.lookups - st.misses);
+
+    REQUIRE(st.index_bytes == i.index_bytes());
+    REQUIRE(st.load_factor > 0.0);
+    REQUIRE(st.load_factor <= 1.0);
+    REQUIRE(st.arena_used > bytes);
+    REQUIRE(st.arena_used <= st.arena_reserved);
+    REQUIRE(st.arena_used == i.allocator().used());
+}
+
+TEST_CASE("statistics of the compact index")
+{
+    x::interner<counted_compact_traits> i;
+    for(auto& s : words)
+    {
+        REQUIRE(i.far(s) == s);
+    }
+    const auto st = i.stats();
+    REQUIRE(st.misses == i.size());
+    REQUIRE(st.hits == words.size() - i.size());
+    REQUIRE(st.load_factor > 0.3);
+    REQUIRE(st.load_factor <= 7.0 / 8);
+
+    // Every string is found, most of them in the first group
+    const auto probes = i.probe_lengths();
+    REQUIRE(!probes.empty());
+    REQUIRE(std::accumulate(probes.begin(), probes.end(), std::size_t{0})
+            == i.size());
+    REQUIRE(probes[0] * 2 > i.size());
+}
+
+TEST_CASE("front cache hits are counted")
+{
+    x::interner<counted_cached_traits> i;
+    for(int r = 0; r != 10; ++r)
+    {
+        REQUIRE(i.far("hot") == std::string("hot"));
+    }
+    const auto st = i.stats();
+    REQUIRE(st.lookups == 10);
+    REQUIRE(st.misses == 1);
+    REQUIRE(st.hits == 9);
+}
+
+TEST_CASE("statistics of a concurrent interner")
+{
+    x::interner<counted_concurrent_traits> i;
+    constexpr std::size_t kThreads = 4;
+    std::vector<std::thread> threads;
+    for(std::size_t t = 0; t != kThreads; ++t)
+    {
+        threads.emplace_back([&i]
+        {
+            for(auto& s : words)
+            {
+                i.far(s);
+            }
+        });
+    }
+    // Polled while the others intern
+    for(int n = 0; n != 100; ++n)
+    {
+        const auto st = i.stats();
+        REQUIRE(st.lookups <= kThreads * words.size());
+    }
+    for(auto& th : threads)
+    {
+        th.join();
+    }
+
+    const auto st = i.stats();
+    REQUIRE(st.lookups == kThreads * words.size());
+    REQUIRE(st.misses == i.size());
+    REQUIRE(st.misses == distinct_words());
+    REQUIRE(st.hits == st.lookups - st.misses);
+    REQUIRE(total(st.lengths) == st.misses);
+}
+
+TEST_CASE("statistics dump")
+{
+    x::interner<counted_traits> i;
+    i.far("a");
+    i.far("a");
+    i.far("abcd");
+    std::ostringstream o;
+    o << i.stats();
+    const auto line = o.str();
+    REQUIRE(line.find("lookups=3 hits=1 misses=2 ") == 0);
+    REQUIRE(line.find(" distinct=2 ") != std::string::npos);
+    REQUIRE(line.find(" string_bytes=5 ") != std::string::npos);
+    REQUIRE(line.find(" lengths=0,1,0,1,0,") != std::string::npos);
+}
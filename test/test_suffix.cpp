@@ -0,0 +1,53 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2019 jh0x
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "test_interner.h"
+
+#include <intern/suffix_report.hpp>
+
+TEST_CASE("suffix_report")
+{
+    const std::vector<std::string> in = {
+        "EURUSD", "USD", "GBPUSD", "SD", "", "JPY", "USD", "a/b/c", "b/c"};
+    const auto st = x::suffix_report(in);
+    REQUIRE(st.strings == 8);
+    REQUIRE(st.bytes == 7 + 4 + 7 + 3 + 1 + 4 + 6 + 4);
+    // "", "SD", "USD" and "b/c"
+    REQUIRE(st.suffixes == 4);
+    REQUIRE(st.shared_bytes == 1 + 3 + 4 + 4);
+}
+
+TEST_CASE("suffix_report on interned strings")
+{
+    x::interner<interner_traits4> i;
+    std::vector<x::interner<interner_traits4>::stringF> interned;
+    for(const char* s : {"path/to/file", "to/file", "file", "other"})
+    {
+        interned.push_back(i.far(s, std::strlen(s)));
+    }
+    const auto st = x::suffix_report(interned);
+    REQUIRE(st.strings == 4);
+    REQUIRE(st.suffixes == 2);
+    REQUIRE(st.shared_bytes == 8 + 5);
+
+    REQUIRE(x::suffix_report(std::vector<std::string>{}).strings == 0);
+}
@@ -0,0 +1,110 @@
+// The MIT License (MIT)
+//
+// Copyright (c) 2019 jh0x
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "test_interner.h"
+
+#include <intern/details/hash.hpp>
+
+namespace
+{
+
+template<typename STraits>
+void check_words()
+{
+    using interner_t = x::interner<interner_traits4, STraits>;
+    using tiny_t = typename interner_t::stringST;
+    using base_t = x::details::string_common<tiny_t, STraits>;
+    interner_t i;
+
+    std::vector<std::string> in = {
+        "", "a", "ab", "abc", "abcdefg", "abcdefgh", "b", "B",
+        std::string("a\0", 2), std::string("a\0b", 3), "\xff", "\x7f"};
+    for(std::size_t k = 0; k < words.size(); k += 37)
+    {
+        in.push_back(words[k]);
+        in.push_back(words[k].substr(0, 3));
+    }
+    std::vector<tiny_t> tiny;
+    for(auto& s : in)
+    {
+        tiny.push_back(i.tiny(s));
+    }
+
+    for(std::size_t a = 0; a != tiny.size(); ++a)
+    {
+        for(std::size_t b = 0; b != tiny.size(); ++b)
+        {
+            const tiny_t& x = tiny[a];
+            const tiny_t& y = tiny[b];
+            // Word paths vs the generic ones
+            const base_t& gx = x;
+            const base_t& gy = y;
+            REQUIRE((x == y) == (gx == gy));
+            REQUIRE((x != y) == (gx != gy));
+            REQUIRE((x < y) == (gx < gy));
+            REQUIRE((x <= y) == (gx <= gy));
+            REQUIRE((x > y) == (gx > gy));
+            REQUIRE((x >= y) == (gx >= gy));
+            REQUIRE((x == y) == (in[a] == in[b]));
+            REQUIRE((x < y) == (in[a] < in[b]));
+        }
+    }
+}
+
+}
+
+TEST_CASE("tiny strings compare as words")
+{
+    check_words<Default>();
+    check_words<DefaultFarDeep>();
+    check_words<DefaultRank>();
+}
+
+TEST_CASE("tiny strings with their own cmp/eq")
+{
+    x::interner<interner_traits4, DefaultStrOps> i;
+    // strncmp stops at the first NUL
+    REQUIRE(i.tiny(std::string("a\0b", 3)) == i.tiny(std::string("a\0c", 3)));
+    REQUIRE(!(i.tiny(std::string("a\0b", 3)) < i.tiny(std::string("a\0c", 3))));
+    REQUIRE(i.tiny("abc") < i.tiny("abd"));
+}
+
+TEST_CASE("tiny strings hash their word")
+{
+    x::interner<interner_traits4, DefaultHash> i;
+    for(auto& s : words)
+    {
+        const auto t = i.tiny(s);
+        if(t.small())
+        {
+            REQUIRE(t.hash() == x::details::hash_small(s.data(), s.size()));
+            if(i.sso2<24>(s).small())
+            {
+                REQUIRE(t.hash() == i.sso2<24>(s).hash());
+            }
+        }
+        else
+        {
+            REQUIRE(t.hash() == i.far(s).hash());
+        }
+    }
+}